@@ -0,0 +1,217 @@
+#include <m3c/rt/main.h>
+
+#include <m3c/common/macros.h>
+#include <m3c/common/utf8.h>
+#include <m3c/rt/alloc.h>
+#include <m3c/rt/mem.h>
+#include <m3c/rt/runtime.h>
+#include <m3c/rt/scan.h>
+#include <m3c/rt/syscalls.h>
+
+#include <linux/time.h> /* for clock ids and `struct timespec` */
+
+/** \file
+ * Micro-benchmark of #m3c_memfill against the loop it replaced (one #m3c_memcpy per repetition).
+ *
+ * It isn't a part of any build. To run it, build it with the runtime sources in place of
+ * `src/driver/main.c`, e.g.:
+ *
+ *     gcc -std=gnu11 -O2 -ffreestanding -fno-builtin -fno-stack-protector -nostdlib -static \
+ *         -Iinclude -DM3C_FEATURE_API_SYSCALLS -o memfill bench/memfill.c \
+ *         $(find src/common src/core src/rt -name '*.[cS]')
+ *
+ * For each pattern length and fill size from #__M3C_BENCH_MIN_SIZE to #__M3C_BENCH_MAX_SIZE it
+ * prints the throughput of both versions in MB/s.
+ */
+
+/**
+ * \brief Size of the smallest fill in bytes.
+ */
+#define __M3C_BENCH_MIN_SIZE 64
+
+/**
+ * \brief Size of the largest fill in bytes.
+ */
+#define __M3C_BENCH_MAX_SIZE (64 * 1024 * 1024)
+
+/**
+ * \brief Number of bytes filled by one measurement (the fill is repeated to reach it).
+ */
+#define __M3C_BENCH_BYTES_PER_RUN (256 * 1024 * 1024)
+
+/**
+ * \brief Lengths of the patterns.
+ *
+ * \note Patterns of 1, 4 and 8 bytes go through the pattern kernels, the others are copied in
+ * doubling chunks.
+ */
+static m3c_size_t const __m3c_lens[] = {1, 3, 4, 8, 12, 64};
+
+/**
+ * \brief Pattern bytes (the first `len` ones are used).
+ */
+static m3c_u8 const __m3c_pattern[64] = "0123456789abcdefghijklmnopqrstuv"
+                                        "wxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_.";
+
+/**
+ * \brief The loop #m3c_memfill used before it filled in doubling chunks.
+ */
+void *__M3C_Bench_MemfillLoop(
+    void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t len, m3c_size_t count
+) {
+    const char *end = (char *)dest + len * count;
+    char *ptr = dest;
+
+    for (; ptr < end; ptr += len)
+        m3c_memcpy(ptr, src, len);
+
+    return dest;
+}
+
+/**
+ * \brief Signature shared by #m3c_memfill and #__M3C_Bench_MemfillLoop.
+ */
+typedef void *(*__M3C_Bench_MemfillFn)(
+    void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t len, m3c_size_t count
+);
+
+/**
+ * \brief Writes the null-terminated string to `stdout`.
+ */
+void __M3C_Bench_PutStr(char const *str) {
+    long len = 0;
+
+    while (str[len])
+        ++len;
+
+    m3c_syscall_write(1, str, len);
+}
+
+/**
+ * \brief Writes the decimal number right-aligned to `width` characters to `stdout`.
+ */
+void __M3C_Bench_PutNum(m3c_size_t num, int width) {
+    char digits[24];
+    int len = 0;
+
+    do {
+        digits[sizeof(digits) - 1 - len++] = (char)('0' + num % 10);
+        num /= 10;
+    } while (num);
+
+    for (; len < width && len < (int)sizeof(digits); ++len)
+        digits[sizeof(digits) - 1 - len] = ' ';
+
+    m3c_syscall_write(1, &digits[sizeof(digits) - len], len);
+}
+
+/**
+ * \brief Returns the monotonic time in nanoseconds.
+ */
+m3c_size_t __M3C_Bench_Now(void) {
+    struct timespec ts;
+
+    m3c_syscall2(SYS_clock_gettime, CLOCK_MONOTONIC, (long)&ts);
+
+    return (m3c_size_t)ts.tv_sec * 1000000000U + (m3c_size_t)ts.tv_nsec;
+}
+
+/**
+ * \brief Fills `size` bytes with the pattern of length `len` until #__M3C_BENCH_BYTES_PER_RUN
+ * bytes are filled and returns the throughput in MB/s.
+ */
+m3c_size_t __M3C_Bench_Run(
+    __M3C_Bench_MemfillFn fill, m3c_u8 *buf, m3c_size_t len, m3c_size_t size
+) {
+    m3c_size_t count = size / len;
+    m3c_size_t reps = __M3C_BENCH_BYTES_PER_RUN / size;
+    m3c_size_t i;
+    m3c_size_t start;
+    m3c_size_t ns;
+
+    /* NOTE: the first fill faults the pages in, so it isn't measured */
+    fill(buf, __m3c_pattern, len, count);
+
+    start = __M3C_Bench_Now();
+    for (i = 0; i < reps; ++i)
+        fill(buf, __m3c_pattern, len, count);
+    ns = __M3C_Bench_Now() - start;
+
+    return count * len * reps * 1000 / (ns ? ns : 1);
+}
+
+/**
+ * \brief Checks that both versions fill the same bytes.
+ */
+m3c_bool __M3C_Bench_Check(m3c_u8 *buf, m3c_u8 *expected, m3c_size_t len, m3c_size_t size) {
+    m3c_size_t count = size / len;
+    m3c_size_t i;
+
+    /* NOTE: the byte after the fill must stay untouched */
+    buf[count * len] = expected[count * len] = 0xA5;
+    __M3C_Bench_MemfillLoop(expected, __m3c_pattern, len, count);
+    m3c_memfill(buf, __m3c_pattern, len, count);
+
+    for (i = 0; i <= count * len; ++i)
+        if (buf[i] != expected[i])
+            return m3c_false;
+
+    return m3c_true;
+}
+
+int main(int argc, char *argv[]) {
+    m3c_u8 *buf;
+    m3c_u8 *expected;
+    m3c_size_t i;
+    m3c_size_t size;
+    m3c_size_t loop;
+    m3c_size_t fill;
+
+    (void)argc;
+    (void)argv;
+
+#ifdef M3C_FEATURE_API_SYSCALLS
+    if (M3C_Runtime_New()) {
+        __M3C_Bench_PutStr("memfill: fatal error: can't init runtime\n");
+
+        return 2;
+    }
+#else
+    M3C_Mem_Init();
+    M3C_Scan_Init();
+    M3C_UTF8_Init();
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+    buf = (m3c_u8 *)m3c_malloc(__M3C_BENCH_MAX_SIZE + 1);
+    expected = (m3c_u8 *)m3c_malloc(__M3C_BENCH_MAX_SIZE + 1);
+    if (!buf || !expected) {
+        __M3C_Bench_PutStr("memfill: fatal error: out of memory\n");
+
+        return 2;
+    }
+
+    __M3C_Bench_PutStr("len     size     loop MB/s  memfill MB/s\n");
+    for (i = 0; i < sizeof(__m3c_lens) / sizeof(__m3c_lens[0]); ++i) {
+        for (size = __M3C_BENCH_MIN_SIZE; size <= __M3C_BENCH_MAX_SIZE; size *= 4) {
+            if (!__M3C_Bench_Check(buf, expected, __m3c_lens[i], size)) {
+                __M3C_Bench_PutStr("memfill: error: the fills differ\n");
+
+                return 1;
+            }
+
+            loop = __M3C_Bench_Run(__M3C_Bench_MemfillLoop, buf, __m3c_lens[i], size);
+            fill = __M3C_Bench_Run(m3c_memfill, buf, __m3c_lens[i], size);
+
+            __M3C_Bench_PutNum(__m3c_lens[i], 3);
+            __M3C_Bench_PutNum(size, 9);
+            __M3C_Bench_PutNum(loop, 14);
+            __M3C_Bench_PutNum(fill, 14);
+            __M3C_Bench_PutStr("\n");
+        }
+    }
+
+    m3c_free(buf);
+    m3c_free(expected);
+
+    return 0;
+}
@@ -147,13 +147,15 @@ typedef struct __tagM3C_ASM_DiagnosticsData {
      */
     M3C_ASM_hToken hToken;
     /**
-     * \brief Start position.
+     * \brief Byte offset of the start from the start of the document.
+     *
+     * \see #M3C_ASM_Document_GetPosition
      */
-    M3C_ASM_Position start;
+    m3c_u32 start;
     /**
-     * \brief End position (exclusive).
+     * \brief Byte offset of the end (exclusive) from the start of the document.
      */
-    M3C_ASM_Position end;
+    m3c_u32 end;
 } M3C_ASM_DiagnosticsData;
 
 #endif /* _M3C_INCGUARD_ASM_DIAGNOSTICS_H */
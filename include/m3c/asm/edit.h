@@ -0,0 +1,62 @@
+#ifndef _M3C_INCGUARD_ASM_EDIT_H
+#define _M3C_INCGUARD_ASM_EDIT_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/errors.h>
+
+#include <m3c/asm/types.h>
+#include <m3c/asm/preproc.h>
+
+/**
+ * \brief Replaces the bytes of the document in the range with the text and updates the lexed
+ * document.
+ *
+ * \details The document gets a new buffer it owns (see #M3C_ASM_DOCUMENT_BUF_ALLOCATED). If the
+ * document is already split (see #__M3C_ASM_Document_SplitLines) and lexed (see #M3C_ASM_lex), its
+ * caches are updated in place:
+ * + \ref M3C_ASM_Document::fragments "fragments" are split again from the fragment before the edit
+ * until the split points of the new and the old bytes meet
+ * + \ref M3C_ASM_Document::tokens "tokens" are lexed again from the \ref term_logical_line
+ * "logical line" of the edit until an \ref term_eol "EOL" token ends where an old one ended (a
+ * token starting after an EOL doesn't depend on the bytes before it)
+ * + \ref M3C_ASM_Document::diagnostics "diagnostics" of the lexed again tokens are replaced
+ *
+ * The fragments, the tokens and the diagnostics after the edit are kept: their offsets, lines and
+ * handles are just shifted. So lexing takes time proportional to the size of the edit (and of the
+ * lines around it).
+ *
+ * \note The new buffer is a copy of the kept bytes and the text, so an edit copies the whole
+ * document once (and shifts the caches after the edit). These are plain memory moves, much cheaper
+ * than splitting and lexing the document again. A gap buffer or a piece table would avoid the copy,
+ * but the lexer, the tokens and the diagnostics address the document as one contiguous buffer.
+ * \note Only the strings of the string pool referencing the document are visited (see \ref
+ * M3C_ASM_Document::stringRefs "document::stringRefs"): the ones referencing the replaced bytes are
+ * copied into the pool (see #__M3C_ASM_StringPool_Detach), the others are moved to the new buffer
+ * (see #__M3C_ASM_StringPool_Move). The old buffer is released if the document owns it.
+ * \note Lexemes of the replaced string literals stay in the string pool unused.
+ * \note If the document isn't split yet, only its buffer is replaced and its diagnostics are
+ * dropped. If it's split but has no tokens (e.g. it's lexed by #M3C_ASM_Lexer_Next), it's lexed
+ * whole and its diagnostics are replaced.
+ *
+ * \warning The tokens of a split document must be either none or all of them (see #M3C_ASM_lex and
+ * #M3C_ASM_lexParallel). Tokens lexed partly (e.g. #M3C_ASM_lex failed) are taken as the whole
+ * document, so the edited document misses the rest of them.
+ *
+ * \param[in,out] preproc   preprocessor
+ * \param         hDocument document handle (the document index in `preproc::documents`)
+ * \param         range     replaced bytes (byte offsets in the document)
+ * \param[in]     text      new bytes (can be `NULL` if `textLen` is `0`)
+ * \param         textLen   number of the new bytes
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_BAD_HANDLE - if there is no such document
+ * + #M3C_ERROR_OOB - if the range is out of the document or the edited document is longer than
+ * #M3C_ASM_DOCUMENT_MAX_BLEN bytes
+ * + #M3C_ERROR_OOM - if the function lacks memory. The document is intact
+ */
+M3C_ERROR M3C_ASM_Document_ApplyEdit(
+    M3C_ASM_PreProc *preproc, M3C_ASM_hDocument hDocument, M3C_ASM_Range range, m3c_u8 const *text,
+    m3c_size_t textLen
+);
+
+#endif /* _M3C_INCGUARD_ASM_EDIT_H */
@@ -4,16 +4,6 @@
 #include <m3c/common/errors.h>
 #include <m3c/asm/types.h>
 
-#ifndef M3C_LEX_STRING_START_CAP
-/**
- * \brief The initial capacity for \ref M3C_ASM_TOKEN_KIND_STRING "string literal" lexeme.
- *
- * \details We assume that the majority of strings will serve as variable or label identifiers, and
- * therefore, their length will be limited to three characters.
- */
-#    define M3C_LEX_STRING_START_CAP 4
-#endif
-
 /**
  * \brief Token kind.
  */
@@ -180,21 +170,22 @@ typedef enum __tagM3C_ASM_TokenKind {
      * + `\r\n`
      * + `\r`
      *
-     * \note The \ref M3C_ASM_Token::end "end" of tokens of this kind is always set to the start
-     * of a new line.
+     * \note Tokens of this kind always cover the whole sequence, so they end at the start of a new
+     * line.
      */
     M3C_ASM_TOKEN_KIND_EOL
 } M3C_ASM_TokenKind;
 
 /**
- * \brief Maximum token length in code points (due to \ref M3C_ASM_Position "Position" constraints).
+ * \brief Maximum token length in code points (due to \ref M3C_ASM_Token::len "Token::len"
+ * constraints).
  */
-#define M3C_ASM_Token_MAX_CLEN ((m3c_u32)M3C_U16_MAX * (m3c_u32)M3C_U16_MAX)
+#define M3C_ASM_Token_MAX_CLEN ((m3c_u32)0xFFFFFFFFU)
 
 /**
  * \brief Lexeme - the "value" of the token.
  */
-typedef union __tagM3C_ASM_Lexeme {
+union __tagM3C_ASM_Lexeme {
     /**
      * \brief Integer value.
      *
@@ -210,9 +201,10 @@ typedef union __tagM3C_ASM_Lexeme {
      *
      * \note This handle in the current implementation corresponds to the index in \ref
      * __tagM3C_ASM_PreProc::stringPool "preproc's string pool".
+     * \note Symbols are interned, so equal symbols have equal handles.
      */
     m3c_u32 hStr;
-} M3C_ASM_Lexeme;
+};
 
 /**
  * \brief Token.
@@ -238,16 +230,18 @@ struct __tagM3C_ASM_Token {
      */
     M3C_ASM_TokenKind kind;
     /**
-     * \brief Position of the first character of this token.
+     * \brief Offset of the first byte of this token from the start of the document.
+     *
+     * \see #M3C_ASM_Document_GetPosition
      */
-    M3C_ASM_Position start;
+    m3c_u32 offset;
     /**
-     * \brief Position of the end of token (exclusive).
+     * \brief Length of this token in bytes.
      *
-     * \note If the token kind is \ref M3C_ASM_TOKEN_KIND_EOL "EOL", the field is set to the start
-     * of a new line.
+     * \note When using preprocessor, the length also counts \ref term_lcs
+     * "line continuation sequences" inside the token.
      */
-    M3C_ASM_Position end;
+    m3c_u32 len;
 };
 
 /**
@@ -0,0 +1,196 @@
+#ifndef _M3C_INCGUARD_ASM_LEXER_H
+#define _M3C_INCGUARD_ASM_LEXER_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/errors.h>
+
+#include <m3c/core/diagnostics.h>
+
+#include <m3c/asm/types.h>
+#include <m3c/asm/lex.h>
+#include <m3c/asm/preproc.h>
+#include <m3c/asm/tokens.h>
+
+#ifndef M3C_ASM_LEXER_WINDOW_LEN
+/**
+ * \brief Number of fragments the lexer splits at once when it splits the document lazily (see
+ * #M3C_ASM_Lexer_Init).
+ */
+#    define M3C_ASM_LEXER_WINDOW_LEN 64
+#endif
+
+/**
+ * \brief Checks that the lexer starts a token at the start of the fragment `NEXT` that follows the
+ * fragment `PREV`.
+ *
+ * \details It's so if `PREV` ends with an \ref term_eol "EOL" sequence. Except `\r` followed by an
+ * empty fragment: the lexer reads `\r` and `\n` separated by a \ref term_lcs "line continuation
+ * sequence" as one EOL token.
+ *
+ * \note Tokens after such a boundary don't depend on the bytes before it, so the fragments can be
+ * lexed from there on their own.
+ */
+#define __M3C_ASM_LEXER_IS_TOKEN_BOUNDARY(PREV, NEXT)                                              \
+    ((PREV)->bLast && (*(PREV)->bLast == '\n' || (*(PREV)->bLast == '\r' && (NEXT)->bLast)))
+
+/**
+ * \brief Lexer.
+ *
+ * \details Either lexes the whole document into its \ref M3C_ASM_Document::tokens "tokens" (see
+ * #M3C_ASM_lex) or yields tokens batch by batch (see #M3C_ASM_Lexer_Next).
+ *
+ * \note The lexer doesn't allocate memory of its own, so it has no deinit function.
+ */
+struct __tagM3C_ASM_Lexer {
+    m3c_u8 const *ptr;
+    /**
+     * \brief Pointer to the first byte of the document (token offsets are counted from it).
+     */
+    m3c_u8 const *bFirst;
+    M3C_ASM_Fragment *fragment;
+    M3C_ASM_Fragment *fragmentLast;
+    /**
+     * \brief Actual token.
+     */
+    M3C_ASM_Token token;
+    /**
+     * \brief Tokens of the document (or `NULL` if the tokens are written to the #batch).
+     */
+    M3C_ASM_Tokens *tokens;
+    /**
+     * \brief Batch of tokens (see #M3C_ASM_Lexer_Next).
+     */
+    M3C_ASM_Token *batch;
+    /**
+     * \brief Number of tokens written to the #batch.
+     */
+    m3c_size_t batchLen;
+    /**
+     * \brief Number of tokens lexed so far (it's also the handle of the next token).
+     */
+    m3c_size_t nTokens;
+    M3C_Diagnostics *diagnostics;
+    /**
+     * \brief Preproc's stringPool.
+     */
+    M3C_ASM_StringPool *stringPool;
+    /**
+     * \brief Records the symbol lexemes referencing the document (or `NULL`, see
+     * #__M3C_ASM_StringPool_InternRef).
+     */
+    M3C_ASM_StringRefs *stringRefs;
+    /**
+     * \brief Lexeme of the string literal being lexed. It's written right into the reserved bytes
+     * of the #stringPool (see #__M3C_ASM_StringPool_Extend).
+     */
+    m3c_u8 *str;
+    /**
+     * \brief Number of bytes written to #str.
+     */
+    m3c_size_t strLen;
+    /**
+     * \brief Whether the document is known to be valid UTF-8.
+     */
+    m3c_bool isValidUTF8;
+    /**
+     * \brief Splits the next fragments into the #window when the lexer reaches #fragmentLast.
+     *
+     * \note If the lexer uses \ref M3C_ASM_Document::fragments "the fragment cache", its \ref
+     * M3C_ASM_LineSplitter::ptr "ptr" is `NULL`, so it splits nothing.
+     */
+    M3C_ASM_LineSplitter splitter;
+    /**
+     * \brief Fragments split lazily.
+     *
+     * \details A token can't be reread, so the fragments before the current one are not needed
+     * and are overwritten by the next ones.
+     */
+    M3C_ASM_Fragment window[M3C_ASM_LEXER_WINDOW_LEN];
+};
+
+/**
+ * \brief Prepares the lexer to yield tokens of the document batch by batch.
+ *
+ * \details The document isn't split into \ref M3C_ASM_Document::fragments "fragments" up front:
+ * they are split lazily into the \ref M3C_ASM_Lexer::window "window" of fixed size. Tokens aren't
+ * pushed to \ref M3C_ASM_Document::tokens "document tokens" either, so the memory used by lexing
+ * doesn't grow with the document (except for its diagnostics and lexemes).
+ *
+ * \note The lexer validates the code points if the \ref M3C_ASM_Document::encoding "encoding" of
+ * the document is unknown.
+ * \note To compute positions of the tokens and the diagnostics (see
+ * #M3C_ASM_Document_GetPosition), the document must be split by #__M3C_ASM_Document_SplitLines.
+ *
+ * \param[out]    lexer      lexer
+ * \param[in,out] preproc    preprocessor
+ * \param         hDocument  document handle (the document index in `preproc::documents`)
+ * \param         usePreproc see #__M3C_ASM_Document_SplitLines
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_BAD_HANDLE - if there is no such document
+ * + #M3C_ERROR_OOB - if the document is longer than #M3C_ASM_DOCUMENT_MAX_BLEN bytes
+ */
+M3C_ERROR M3C_ASM_Lexer_Init(
+    M3C_ASM_Lexer *lexer, M3C_ASM_PreProc *preproc, M3C_ASM_hDocument hDocument,
+    m3c_bool usePreproc
+);
+
+/**
+ * \brief Lexes the next tokens of the document.
+ *
+ * \details Diagnostics are pushed to \ref M3C_ASM_Document::diagnostics "document diagnostics" and
+ * their \ref M3C_ASM_DiagnosticsData::hToken "hToken" counts the yielded tokens.
+ *
+ * \param[in,out] lexer lexer (see #M3C_ASM_Lexer_Init)
+ * \param[out]    batch writes the tokens here
+ * \param         n     maximum number of tokens to write (must be greater than `0`)
+ * \param[out]    len   writes here the number of written tokens
+ * \return
+ * + #M3C_ERROR_OK - `len` is less than `n` only if the end of the document is reached
+ * + #M3C_ERROR_EOF - if there are no tokens left (`len` is `0`)
+ * + #M3C_ERROR_OOM - if failed to push diagnostic or lexeme
+ */
+M3C_ERROR M3C_ASM_Lexer_Next(
+    M3C_ASM_Lexer *lexer, M3C_ASM_Token *batch, m3c_size_t n, m3c_size_t *len
+);
+
+/**
+ * \brief Inits the fields of the lexer that don't depend on where the tokens go.
+ *
+ * \details The lexer starts at the first byte of the document and pushes diagnostics to \ref
+ * M3C_ASM_Document::diagnostics "document diagnostics" and references of lexemes to \ref
+ * M3C_ASM_Document::stringRefs "document stringRefs".
+ *
+ * \param[out]    lexer    lexer
+ * \param[in,out] preproc  preprocessor
+ * \param[in,out] document document
+ */
+void __M3C_ASM_Lexer_InitCommon(
+    M3C_ASM_Lexer *lexer, M3C_ASM_PreProc *preproc, M3C_ASM_Document *document
+);
+
+/**
+ * \brief Splits the next fragments into the \ref M3C_ASM_Lexer::window "window" and moves the
+ * lexer to the first of them.
+ *
+ * \param[in,out] lexer lexer
+ * \return whether there are any fragments left
+ */
+m3c_bool __M3C_ASM_Lexer_SplitMore(M3C_ASM_Lexer *lexer);
+
+/**
+ * \brief Lexes the next token (if there is one).
+ *
+ * \details The token is dispatched on its first byte by `__M3C_ASM_LEX_ACTIONS`.
+ *
+ * \note If EOF is reached but no token is found, #M3C_ERROR_OK is returned.
+ *
+ * \param[in,out] lexer lexer
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_EOF - if EOF is reached
+ * + #M3C_ERROR_OOM - if failed to push token, diagnostic, or lexeme
+ */
+M3C_ERROR __M3C_ASM_Lexer_NextToken(M3C_ASM_Lexer *lexer);
+
+#endif /* _M3C_INCGUARD_ASM_LEXER_H */
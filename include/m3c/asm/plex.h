@@ -0,0 +1,55 @@
+#ifndef _M3C_INCGUARD_ASM_PLEX_H
+#define _M3C_INCGUARD_ASM_PLEX_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/errors.h>
+
+#include <m3c/asm/types.h>
+#include <m3c/asm/preproc.h>
+
+#ifndef M3C_ASM_PLEX_MIN_BLEN
+/**
+ * \brief Minimum number of document bytes lexed by one worker of #M3C_ASM_lexParallel.
+ *
+ * \details Smaller ranges aren't worth a thread (and its arena).
+ */
+#    define M3C_ASM_PLEX_MIN_BLEN ((m3c_size_t)1024 * 1024)
+#endif
+
+/**
+ * \brief Lexes the given document by several workers at once.
+ *
+ * \details The \ref M3C_ASM_Document::fragments "fragments" are partitioned into ranges of \ref
+ * term_physical_line "lines" of about the same number of bytes. Each range ends with an \ref
+ * term_eol "EOL" sequence after which a token starts (see #__M3C_ASM_LEXER_IS_TOKEN_BOUNDARY), so
+ * the ranges are lexed on their own. The first range is lexed by the calling thread right into the
+ * document, the others by spawned threads into their own tokens, diagnostics and string pools. Then
+ * their results are appended to the document: the handles of the tokens (and of the diagnostics)
+ * are shifted and the lexemes are interned (copied unless they reference the document buffer) into
+ * \ref M3C_ASM_PreProc::stringPool "preproc's string pool".
+ *
+ * The tokens and the diagnostics are the same as #M3C_ASM_lex produces. Only the handles of the
+ * string lexemes may be numbered in another order.
+ *
+ * \note Each worker lexes at least #M3C_ASM_PLEX_MIN_BLEN bytes, so a small document is lexed by
+ * the calling thread only.
+ * \note If a thread can't be spawned (or the runtime has no threads, i.e. without
+ * `M3C_FEATURE_API_SYSCALLS`), its range is lexed by the calling thread.
+ * \note Each spawned thread takes an arena of the runtime heap (see #M3C_RuntimeThread). Its
+ * results are copied to the document and the pool before it finishes, so the arena is reused by the
+ * threads of later calls.
+ *
+ * \param[in,out] preproc   preprocessor
+ * \param         hDocument document handle (the document index in `preproc::documents`)
+ * \param         nWorkers  maximum number of workers (including the calling thread)
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_BAD_HANDLE - if there is no such document
+ * + #M3C_ERROR_OOB - if the document is longer than #M3C_ASM_DOCUMENT_MAX_BLEN bytes
+ * + #M3C_ERROR_OOM - if failed to push token, diagnostic, or lexeme
+ */
+M3C_ERROR M3C_ASM_lexParallel(
+    M3C_ASM_PreProc *preproc, M3C_ASM_hDocument hDocument, m3c_size_t nWorkers
+);
+
+#endif /* _M3C_INCGUARD_ASM_PLEX_H */
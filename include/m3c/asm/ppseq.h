@@ -2,6 +2,7 @@
 #define _M3C_INCGUARD_ASM_PPSEQ_H
 
 #include <m3c/asm/types.h>
+#include <m3c/asm/tokens.h>
 
 #include <m3c/core/diagnostics.h>
 
@@ -96,7 +97,7 @@ struct __tagM3C_ASM_Rel {
  */
 typedef struct __tagM3C_ASM_PPSeq {
     /**
-     * \brief Vector of \ref M3C_ASM_Token "tokens".
+     * \brief Tokens.
      */
     M3C_ASM_Tokens toks;
     /**
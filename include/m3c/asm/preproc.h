@@ -9,6 +9,7 @@
 
 #include <m3c/asm/types.h>
 #include <m3c/asm/ppseq.h>
+#include <m3c/asm/tokens.h>
 
 /** \file
  * Preprocessor routines.
@@ -125,6 +126,52 @@ typedef struct __tagM3C_ASM_Fragment {
     M3C_ASM_Position pos;
 } M3C_ASM_Fragment;
 
+/**
+ * \brief Encoding of the document bytes.
+ *
+ * \see \ref M3C_ASM_Document::encoding "document::encoding"
+ */
+typedef enum __tagM3C_ASM_DocumentEncoding {
+    /**
+     * \brief The document isn't checked yet.
+     */
+    M3C_ASM_DOCUMENT_ENCODING_UNKNOWN = 0,
+    /**
+     * \brief The document contains invalid UTF-8 sequences.
+     */
+    M3C_ASM_DOCUMENT_ENCODING_INVALID = 1,
+    /**
+     * \brief The document is valid UTF-8.
+     */
+    M3C_ASM_DOCUMENT_ENCODING_UTF8 = 2,
+    /**
+     * \brief The document is valid UTF-8 and contains only ASCII bytes.
+     */
+    M3C_ASM_DOCUMENT_ENCODING_ASCII = 3
+} M3C_ASM_DocumentEncoding;
+
+/**
+ * \brief Owner of the document buffer.
+ *
+ * \see \ref M3C_ASM_Document::buf "document::buf"
+ */
+typedef enum __tagM3C_ASM_DocumentBuf {
+    /**
+     * \brief The buffer is owned by the caller (see #M3C_ASM_Document_Init).
+     */
+    M3C_ASM_DOCUMENT_BUF_BORROWED = 0,
+    /**
+     * \brief The buffer is a file mapping (see #M3C_ASM_Document_InitFromFile). It's unmapped by
+     * #M3C_ASM_Document_Deinit.
+     */
+    M3C_ASM_DOCUMENT_BUF_MAPPED = 1,
+    /**
+     * \brief The buffer is allocated by the document (see #M3C_ASM_Document_ApplyEdit). It's freed
+     * by #M3C_ASM_Document_Deinit.
+     */
+    M3C_ASM_DOCUMENT_BUF_ALLOCATED = 2
+} M3C_ASM_DocumentBuf;
+
 /**
  * \brief See \ref M3C_ASM_Document::fragments "document::fragments".
  */
@@ -139,6 +186,21 @@ typedef struct __tagM3C_ASM_FragmentsCache {
     M3C_ASM_Fragment *data;
 } M3C_ASM_FragmentsCache;
 
+/**
+ * \brief Handles of the strings of the string pool that reference the document bytes (see
+ * #__M3C_ASM_StringPool_InternRef).
+ *
+ * \see \ref M3C_ASM_Document::stringRefs "document::stringRefs"
+ */
+typedef M3C_VEC(m3c_u32) M3C_ASM_StringRefs;
+
+/**
+ * \brief Maximum length of the document in bytes.
+ *
+ * \details Tokens and diagnostics locate themselves with `u32` byte offsets.
+ */
+#define M3C_ASM_DOCUMENT_MAX_BLEN ((m3c_size_t)0xFFFFFFFFU)
+
 struct __tagM3C_ASM_Document {
     /**
      * \brief Pointer to the first byte of this document.
@@ -151,6 +213,22 @@ struct __tagM3C_ASM_Document {
      * equal to `0`).
      */
     m3c_u8 const *bLast;
+    /**
+     * \brief Who owns the buffer of the document.
+     */
+    M3C_ASM_DocumentBuf buf;
+    /**
+     * \brief Encoding of the document bytes.
+     *
+     * \details This field will be filled in during \ref term_phase_ls "Line Splitting Phase". If
+     * the document is known to be valid, the lexer doesn't validate its code points again.
+     */
+    M3C_ASM_DocumentEncoding encoding;
+    /**
+     * \brief Whether \ref term_lcs "line continuation sequences" are cut from the #fragments (see
+     * #__M3C_ASM_Document_SplitLines).
+     */
+    m3c_bool usesPreproc;
     /**
      * \brief Document fragments.
      *
@@ -166,6 +244,8 @@ struct __tagM3C_ASM_Document {
     /**
      * \brief Raw tokens.
      *
+     * \details Stored as a structure of arrays (see #M3C_ASM_Tokens).
+     *
      * \note The tokens will be the same for the same document. There is no need to calculate
      * them each time the same document is included.
      */
@@ -198,8 +278,34 @@ struct __tagM3C_ASM_Document {
      * them each time the same document is included.
      */
     M3C_Diagnostics diagnostics;
+    /**
+     * \brief Strings of the string pool referencing the bytes of this document.
+     *
+     * \details When the buffer is replaced (see #M3C_ASM_Document_ApplyEdit), only these strings
+     * are detached or moved, so the other strings of the pool aren't scanned.
+     */
+    M3C_ASM_StringRefs stringRefs;
 };
 
+#ifndef M3C_ASM_STRING_POOL_CHUNK_SIZE
+/**
+ * \brief Byte size of the string pool chunks.
+ *
+ * \details A string longer than a chunk gets its own chunk.
+ */
+#    define M3C_ASM_STRING_POOL_CHUNK_SIZE 65536
+#endif
+
+/**
+ * \brief Header of the string pool chunk. The bytes of the chunk follow it.
+ */
+typedef struct __tagM3C_ASM_StringChunk {
+    /**
+     * \brief Previously allocated chunk (or `NULL`).
+     */
+    struct __tagM3C_ASM_StringChunk *prev;
+} M3C_ASM_StringChunk;
+
 /**
  * \brief Describes a string in the string pool.
  */
@@ -207,18 +313,67 @@ typedef struct __tagM3C_ASM_CachedString {
     /**
      * \brief Pointer to the string (in UTF-8).
      *
+     * \details Points into a chunk of the string pool or, for strings interned by
+     * #__M3C_ASM_StringPool_InternRef, into the document buffer. Neither is ever moved, so the
+     * pointer is stable (unless the string is detached by #__M3C_ASM_StringPool_Detach or moved by
+     * #__M3C_ASM_StringPool_Move).
+     *
      * \warning The string is not null-terminated.
      */
-    m3c_u8 *ptr;
+    m3c_u8 const *ptr;
     /**
      * \brief The byte length of the string.
      *
      * \warning The string is not null-terminated. The UTF-8 is used.
      */
     m3c_u32 len;
+    /**
+     * \brief Hash of the string (see #__M3C_ASM_StringPool_Intern).
+     *
+     * \note It's set only for interned strings.
+     */
+    m3c_u32 hash;
 } M3C_ASM_CachedString;
 
-typedef M3C_VEC(M3C_ASM_CachedString) M3C_ASM_StringPool;
+/**
+ * \brief String pool.
+ *
+ * \details String bytes are appended to the chunks (an append-only arena), so there is no
+ * allocation per string.
+ */
+typedef struct __tagM3C_ASM_StringPool {
+    /**
+     * \brief Strings. The index of the string is its handle (see \ref M3C_ASM_Lexeme::hStr
+     * "Lexeme::hStr").
+     */
+    M3C_VEC(M3C_ASM_CachedString) strings;
+    /**
+     * \brief Hash table of interned strings (open addressing with linear probing).
+     *
+     * \details Each slot is `hStr + 1` of the string or `0` if the slot is empty.
+     */
+    m3c_u32 *table;
+    /**
+     * \brief Number of slots in the #table (a power of two or `0`).
+     */
+    m3c_u32 tableCap;
+    /**
+     * \brief Number of used slots in the #table.
+     */
+    m3c_u32 tableLen;
+    /**
+     * \brief The last allocated chunk (or `NULL`).
+     */
+    M3C_ASM_StringChunk *chunk;
+    /**
+     * \brief Pointer to the first free byte of the #chunk.
+     */
+    m3c_u8 *chunkPtr;
+    /**
+     * \brief Pointer to the byte after the #chunk.
+     */
+    m3c_u8 *chunkEnd;
+} M3C_ASM_StringPool;
 
 /**
  * \brief Preprocessor.
@@ -248,11 +403,27 @@ struct __tagM3C_ASM_PreProc {
  *
  * \param[in,out] document document struct to init
  * \param         buf      document buffer (source text). Can't be `NULL` even if the document is
- * empty.
+ * empty. Symbol lexemes reference it (see #__M3C_ASM_StringPool_InternRef), so it must outlive the
+ * preprocessor the document is added to.
  * \param         bufLen   length of the document buffer. Can be `0`
  */
 void M3C_ASM_Document_Init(M3C_ASM_Document *document, m3c_u8 const *buf, m3c_size_t bufLen);
 
+/**
+ * \brief Inits the \ref M3C_ASM_Document "document" struct with the file content.
+ *
+ * \details The file is mapped into memory (see #M3C_File_Map) and used as the document buffer
+ * without copying. The document owns the mapping, so it's unmapped by #M3C_ASM_Document_Deinit.
+ *
+ * \param[in,out] document document struct to init
+ * \param[in]     path     path to the file (null-terminated)
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_IO - if the file can't be mapped. The document is not inited
+ */
+M3C_ERROR M3C_ASM_Document_InitFromFile(M3C_ASM_Document *document, char const *path);
+
 /**
  * \brief Deinits the \ref M3C_ASM_Document "document" struct.
  *
@@ -260,6 +431,26 @@ void M3C_ASM_Document_Init(M3C_ASM_Document *document, m3c_u8 const *buf, m3c_si
  */
 void M3C_ASM_Document_Deinit(M3C_ASM_Document const *document);
 
+/**
+ * \brief Computes the position of the byte with the given offset.
+ *
+ * \details Looks up the fragment containing the byte (binary search over the \ref
+ * M3C_ASM_Document::fragments "fragments") and counts the code points before the byte in it. Meant
+ * for rendering diagnostics, so tokens and diagnostics store only byte offsets.
+ *
+ * \note The offset may point right after a fragment (e.g. the end of a token before a \ref
+ * term_lcs "line continuation sequence" or the end of the document). The position after an \ref
+ * term_eol "EOL" sequence is the start of the next line.
+ *
+ * \param[in]  document document (must be split into the fragments)
+ * \param      offset   offset of the byte from the start of the document (at most the length of
+ * the document)
+ * \param[out] pos      writes the position here
+ */
+void M3C_ASM_Document_GetPosition(
+    M3C_ASM_Document const *document, m3c_u32 offset, M3C_ASM_Position *pos
+);
+
 /**
  * \brief Prepares \ref M3C_ASM_PreProc "PreProc" struct for work.
  *
@@ -283,7 +474,8 @@ void M3C_ASM_PreProc_Deinit(M3C_ASM_PreProc const *preProc);
  *
  * \details Splits the document into lines (using \ref term_eol "EOL" sequences), filling the
  * document \ref M3C_ASM_Document::fragments "fragments". If a preprocessor (param `usePreproc`) is
- * used, \ref term_lcs "line continuation sequences" are cut from the fragments.
+ * used, \ref term_lcs "line continuation sequences" are cut from the fragments. Also validates the
+ * document and fills its \ref M3C_ASM_Document::encoding "encoding".
  *
  * \note If the fragments are already filled, returns \ref M3C_ERROR_OK "OK" and does nothing.
  *
@@ -295,4 +487,183 @@ void M3C_ASM_PreProc_Deinit(M3C_ASM_PreProc const *preProc);
  */
 M3C_ERROR __M3C_ASM_Document_SplitLines(M3C_ASM_Document *document, m3c_bool usePreproc);
 
+/**
+ * \brief State of splitting the document into fragments batch by batch.
+ *
+ * \details Lets the fragments be split lazily into a buffer of fixed size instead of \ref
+ * M3C_ASM_Document::fragments "the fragment cache" (see #M3C_ASM_Lexer_Next).
+ */
+typedef struct __tagM3C_ASM_LineSplitter {
+    /**
+     * \brief Document being split.
+     */
+    M3C_ASM_Document const *document;
+    /**
+     * \brief Pointer to the first byte of the next fragment (or `NULL` if the last fragment is
+     * already split).
+     */
+    m3c_u8 const *ptr;
+    /**
+     * \brief Zero-based index of the \ref term_physical_line "physical line" of the next fragment.
+     */
+    m3c_u32 line;
+    /**
+     * \brief Whether \ref term_lcs "line continuation sequences" are cut from the fragments.
+     */
+    m3c_bool usePreproc;
+} M3C_ASM_LineSplitter;
+
+/**
+ * \brief Prepares the splitter to split the document from its start.
+ *
+ * \param[out] splitter   splitter
+ * \param[in]  document   document
+ * \param      usePreproc see #__M3C_ASM_Document_SplitLines
+ */
+void __M3C_ASM_LineSplitter_Init(
+    M3C_ASM_LineSplitter *splitter, M3C_ASM_Document const *document, m3c_bool usePreproc
+);
+
+/**
+ * \brief Splits the next fragments of the document (as #__M3C_ASM_Document_SplitLines does).
+ *
+ * \param[in,out] splitter  splitter
+ * \param[out]    fragments writes the fragments here
+ * \param         maxN      maximum number of fragments to write
+ * \return number of written fragments (`0` if all fragments are already split)
+ */
+m3c_size_t __M3C_ASM_LineSplitter_Split(
+    M3C_ASM_LineSplitter *splitter, M3C_ASM_Fragment *fragments, m3c_size_t maxN
+);
+
+/**
+ * \brief Inits #M3C_ASM_StringPool.
+ *
+ * \param[out] pool string pool
+ */
+void __M3C_ASM_StringPool_Init(M3C_ASM_StringPool *pool);
+
+/**
+ * \brief Deinits #M3C_ASM_StringPool.
+ *
+ * \param[in] pool string pool
+ */
+void __M3C_ASM_StringPool_Deinit(M3C_ASM_StringPool const *pool);
+
+/**
+ * \brief Reserves `n` bytes in the string pool.
+ *
+ * \details The bytes aren't used until #__M3C_ASM_StringPool_Commit is called, so the caller can
+ * reserve an upper bound of the string length and then commit only the written bytes.
+ *
+ * \param[in,out] pool string pool
+ * \param         n    number of bytes
+ * \return pointer to the first reserved byte or `NULL` if the function lacks memory
+ */
+m3c_u8 *__M3C_ASM_StringPool_Reserve(M3C_ASM_StringPool *pool, m3c_size_t n);
+
+/**
+ * \brief Reserves `n` more bytes after `used` reserved bytes, that are already written.
+ *
+ * \details Lets the caller write a string which length isn't known in advance. If the current
+ * chunk has no room, the written bytes are moved to a new one.
+ *
+ * \param[in,out] pool string pool
+ * \param         used number of the reserved bytes that are already written
+ * \param         n    number of bytes to reserve after them
+ * \return pointer to the first reserved byte (it may differ from the previous one) or `NULL` if the
+ * function lacks memory
+ */
+m3c_u8 *__M3C_ASM_StringPool_Extend(M3C_ASM_StringPool *pool, m3c_size_t used, m3c_size_t n);
+
+/**
+ * \brief Marks first `n` reserved bytes (see #__M3C_ASM_StringPool_Reserve) as used.
+ *
+ * \param[in,out] pool string pool
+ * \param         n    number of bytes (not greater than the number of reserved ones)
+ */
+void __M3C_ASM_StringPool_Commit(M3C_ASM_StringPool *pool, m3c_size_t n);
+
+/**
+ * \brief Interns the string.
+ *
+ * \details If the pool already has an interned string equal to `str`, its handle is returned.
+ * Otherwise `str` is copied into the pool. So equal strings share one handle and can be compared
+ * by handles.
+ *
+ * \note `str` can be already written to the reserved bytes (see #__M3C_ASM_StringPool_Reserve). In
+ * this case it's committed instead of copied.
+ *
+ * \param[in,out] pool string pool
+ * \param[in]     str  string (not null-terminated)
+ * \param         len  byte length of the string
+ * \param[out]    hStr writes here the handle of the string
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_StringPool_Intern(
+    M3C_ASM_StringPool *pool, m3c_u8 const *str, m3c_u32 len, m3c_u32 *hStr
+);
+
+/**
+ * \brief As #__M3C_ASM_StringPool_Intern but a new string isn't copied: the pool references `str`.
+ *
+ * \warning `str` must outlive the pool (e.g. be bytes of a document of the same preprocessor) or be
+ * detached before it's freed (see #__M3C_ASM_StringPool_Detach).
+ *
+ * \param[in,out] pool string pool
+ * \param[in,out] refs writes here the handle of a new string (or `NULL` if it's not recorded, e.g.
+ * the pool dies before the bytes)
+ * \param[in]     str  string (not null-terminated)
+ * \param         len  byte length of the string
+ * \param[out]    hStr writes here the handle of the string
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_StringPool_InternRef(
+    M3C_ASM_StringPool *pool, M3C_ASM_StringRefs *refs, m3c_u8 const *str, m3c_u32 len,
+    m3c_u32 *hStr
+);
+
+/**
+ * \brief Copies into the pool the strings of `refs` that have bytes in `[from, to)` or cross `from`
+ * (so they aren't entirely before `from` or entirely at or after `to`) and removes them from
+ * `refs`, so these bytes can be changed or freed.
+ *
+ * \note The handles of the strings aren't changed.
+ *
+ * \param[in,out] pool string pool
+ * \param[in,out] refs strings referencing the buffer of `from` and `to` (see
+ * #__M3C_ASM_StringPool_InternRef)
+ * \param[in]     from pointer to the first byte
+ * \param[in]     to   pointer to the byte after the last one
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory. The strings copied so far stay copied
+ */
+M3C_ERROR __M3C_ASM_StringPool_Detach(
+    M3C_ASM_StringPool *pool, M3C_ASM_StringRefs *refs, m3c_u8 const *from, m3c_u8 const *to
+);
+
+/**
+ * \brief Moves the strings of `refs` that lie entirely in `[from, to)` to the same bytes copied to
+ * `dst`.
+ *
+ * \note The handles of the strings aren't changed, and neither are their bytes, so the hash table
+ * stays valid.
+ *
+ * \param[in,out] pool string pool
+ * \param[in]     refs strings referencing the buffer of `from` and `to` (see
+ * #__M3C_ASM_StringPool_InternRef)
+ * \param[in]     from pointer to the first byte
+ * \param[in]     to   pointer to the byte after the last one
+ * \param[in]     dst  pointer to the copy of the byte `from`
+ */
+void __M3C_ASM_StringPool_Move(
+    M3C_ASM_StringPool *pool, M3C_ASM_StringRefs const *refs, m3c_u8 const *from,
+    m3c_u8 const *to, m3c_u8 const *dst
+);
+
 #endif /* _M3C_INCGUARD_ASM_PREPROC_H */
@@ -0,0 +1,166 @@
+#ifndef _M3C_INCGUARD_ASM_TOKENS_H
+#define _M3C_INCGUARD_ASM_TOKENS_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/coltypes.h>
+#include <m3c/common/errors.h>
+
+#include <m3c/asm/types.h>
+#include <m3c/asm/lex.h>
+
+/**
+ * \brief Value of \ref M3C_ASM_Tokens::lens "Tokens::lens" for tokens whose lengths don't fit into
+ * `u16`.
+ */
+#define M3C_ASM_TOKENS_LONG_LEN M3C_U16_MAX
+
+/**
+ * \brief Length of the long token.
+ */
+typedef struct __tagM3C_ASM_TokenLongLen {
+    /**
+     * \brief Handle of the token.
+     */
+    M3C_ASM_hToken hToken;
+    /**
+     * \brief Length of the token in bytes.
+     */
+    m3c_u32 len;
+} M3C_ASM_TokenLongLen;
+
+/**
+ * \brief Tokens stored as a structure of arrays.
+ *
+ * \details Each field of \ref M3C_ASM_Token "Token" is stored in its own column, so passes that
+ * look only at some fields (e.g. only at kinds) don't load the others. The handle of the token
+ * (#M3C_ASM_hToken) is its index in each column.
+ *
+ * A token is located by its byte offset and byte length in the document. Its line and character
+ * are computed only when needed (see #M3C_ASM_Document_GetPosition), so a token takes 11 bytes
+ * (without its lexeme).
+ *
+ * Use `M3C_ASM_TOKENS_*` macros to access the fields of a specific token.
+ */
+struct __tagM3C_ASM_Tokens {
+    /**
+     * \brief Token kinds (see #M3C_ASM_TokenKind).
+     *
+     * \note All kinds fit into a byte.
+     */
+    m3c_u8 *kinds;
+    /**
+     * \brief Token lexemes (see \ref M3C_ASM_Token::lexeme "Token::lexeme").
+     */
+    M3C_ASM_Lexeme *lexemes;
+    /**
+     * \brief Token offsets (see \ref M3C_ASM_Token::offset "Token::offset").
+     */
+    m3c_u32 *offsets;
+    /**
+     * \brief Token lengths (see \ref M3C_ASM_Token::len "Token::len").
+     *
+     * \note Tokens of #M3C_ASM_TOKENS_LONG_LEN bytes or longer have #M3C_ASM_TOKENS_LONG_LEN here
+     * and their lengths are stored in #longLens.
+     */
+    m3c_u16 *lens;
+    /**
+     * \brief Lengths of long tokens (sorted by the handle, as tokens are only pushed).
+     */
+    M3C_VEC(M3C_ASM_TokenLongLen) longLens;
+    /**
+     * \brief Number of tokens.
+     */
+    m3c_size_t len;
+    /**
+     * \brief Number of tokens each column can hold.
+     */
+    m3c_size_t cap;
+};
+
+/**
+ * \brief Kind (#M3C_ASM_TokenKind) of the token with the handle `H_TOKEN`.
+ */
+#define M3C_ASM_TOKENS_KIND(TOKENS, H_TOKEN) ((M3C_ASM_TokenKind)(TOKENS)->kinds[(H_TOKEN)])
+
+/**
+ * \brief Lexeme (#M3C_ASM_Lexeme) of the token with the handle `H_TOKEN`.
+ */
+#define M3C_ASM_TOKENS_LEXEME(TOKENS, H_TOKEN) ((TOKENS)->lexemes[(H_TOKEN)])
+
+/**
+ * \brief Byte offset (`u32`) of the token with the handle `H_TOKEN`.
+ */
+#define M3C_ASM_TOKENS_OFFSET(TOKENS, H_TOKEN) ((TOKENS)->offsets[(H_TOKEN)])
+
+/**
+ * \brief Byte length (`u32`) of the token with the handle `H_TOKEN`.
+ */
+#define M3C_ASM_TOKENS_LEN(TOKENS, H_TOKEN)                                                        \
+    ((TOKENS)->lens[(H_TOKEN)] != M3C_ASM_TOKENS_LONG_LEN                                          \
+         ? (m3c_u32)(TOKENS)->lens[(H_TOKEN)]                                                      \
+         : __M3C_ASM_Tokens_LongLen((TOKENS), (H_TOKEN)))
+
+/**
+ * \brief Inits #M3C_ASM_Tokens.
+ *
+ * \param[in,out] tokens tokens
+ */
+void __M3C_ASM_Tokens_Init(M3C_ASM_Tokens *tokens);
+
+/**
+ * \brief Deinits #M3C_ASM_Tokens.
+ *
+ * \param[in] tokens tokens
+ */
+void __M3C_ASM_Tokens_Deinit(M3C_ASM_Tokens const *tokens);
+
+/**
+ * \brief Pushes the token.
+ *
+ * \param[in,out] tokens tokens
+ * \param[in]     token  token
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_Tokens_Push(M3C_ASM_Tokens *tokens, M3C_ASM_Token const *token);
+
+/**
+ * \brief Replaces the tokens `[first, last)` with the tokens of `src` and adds `delta` to the
+ * offsets of the tokens after them.
+ *
+ * \param[in,out] tokens tokens
+ * \param         first  handle of the first replaced token
+ * \param         last   handle of the token after the last replaced one
+ * \param[in]     src    new tokens
+ * \param         delta  change of the offsets (modulo \f$2^{32}\f$, so it can be "negative")
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory. The tokens are intact
+ */
+M3C_ERROR __M3C_ASM_Tokens_Splice(
+    M3C_ASM_Tokens *tokens, m3c_size_t first, m3c_size_t last, M3C_ASM_Tokens const *src,
+    m3c_u32 delta
+);
+
+/**
+ * \brief Returns the length of the long token.
+ *
+ * \param[in] tokens tokens
+ * \param     hToken handle of the token (its \ref M3C_ASM_Tokens::lens "lens" entry must be
+ * #M3C_ASM_TOKENS_LONG_LEN)
+ *
+ * \see #M3C_ASM_TOKENS_LEN
+ */
+m3c_u32 __M3C_ASM_Tokens_LongLen(M3C_ASM_Tokens const *tokens, M3C_ASM_hToken hToken);
+
+/**
+ * \brief Gathers all fields of the token.
+ *
+ * \param[in]  tokens tokens
+ * \param      hToken handle of the token (must be less than \ref M3C_ASM_Tokens::len "len")
+ * \param[out] token  writes the token here
+ */
+void M3C_ASM_Tokens_Get(M3C_ASM_Tokens const *tokens, M3C_ASM_hToken hToken, M3C_ASM_Token *token);
+
+#endif /* _M3C_INCGUARD_ASM_TOKENS_H */
@@ -8,9 +8,21 @@
  * forward declarations from <m3c/asm/lex.h>
  **************************************************************************************************/
 
+typedef union __tagM3C_ASM_Lexeme M3C_ASM_Lexeme;
+
 typedef struct __tagM3C_ASM_Token M3C_ASM_Token;
 
-typedef M3C_VEC(M3C_ASM_Token) M3C_ASM_Tokens;
+/***************************************************************************************************
+ * forward declarations from <m3c/asm/lexer.h>
+ **************************************************************************************************/
+
+typedef struct __tagM3C_ASM_Lexer M3C_ASM_Lexer;
+
+/***************************************************************************************************
+ * forward declarations from <m3c/asm/tokens.h>
+ **************************************************************************************************/
+
+typedef struct __tagM3C_ASM_Tokens M3C_ASM_Tokens;
 
 /***************************************************************************************************
  * forward declarations from <m3c/asm/preproc.h>
@@ -36,20 +48,35 @@ typedef struct __tagM3C_ASM_PreProc M3C_ASM_PreProc;
 /**
  * \brief Position (in the source document).
  *
- * \note Implementation limits:
- * + a document can contain only \f$2^{16}-1\f$ lines: \ref M3C_ASM_Position::line "line" is `u16`
- * + each line of the document can contain only \f$2^{16}-1\f$ characters: \ref
- * M3C_ASM_Position::character "character" is `u16`
+ * \details Positions aren't stored in tokens and diagnostics, they are computed from byte offsets
+ * (see #M3C_ASM_Document_GetPosition).
  */
 typedef struct __tagM3C_ASM_Position {
     /**
      * \brief Zero-based index of the line.
      */
-    m3c_u16 line;
+    m3c_u32 line;
     /**
      * \brief Zero-based index of the character in the #line.
      */
-    m3c_u16 character;
+    m3c_u32 character;
 } M3C_ASM_Position;
 
+/**
+ * \brief Range of bytes (in the source document).
+ *
+ * \details The range is half-open: it starts at the byte with the offset #start and ends right
+ * before the byte with the offset #end.
+ */
+typedef struct __tagM3C_ASM_Range {
+    /**
+     * \brief Offset of the first byte of the range.
+     */
+    m3c_u32 start;
+    /**
+     * \brief Offset of the byte after the last byte of the range.
+     */
+    m3c_u32 end;
+} M3C_ASM_Range;
+
 #endif /* _M3C_INCGUARD_ASM_TYPES_H */
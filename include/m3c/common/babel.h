@@ -34,6 +34,19 @@
 
 #if defined(M3C_GNUC) || defined(M3C_CLANG)
 #    define M3C_SYSV_ABI __attribute__((sysv_abi))
+#    define M3C_TARGET(features) __attribute__((target(features)))
+#endif
+
+/* NOTE: atomics are built on compiler builtins as <stdatomic.h> may be absent in C99 (and in
+ * freestanding builds) */
+#if defined(M3C_GNUC) || defined(M3C_CLANG)
+#    define m3c_atomic_load(ptr) __atomic_load_n((ptr), __ATOMIC_ACQUIRE)
+#    define m3c_atomic_store(ptr, val) __atomic_store_n((ptr), (val), __ATOMIC_RELEASE)
+#    define m3c_atomic_fetch_add(ptr, val) __atomic_fetch_add((ptr), (val), __ATOMIC_ACQ_REL)
+#    define m3c_atomic_compare_exchange(ptr, expected, desired)                                    \
+        __atomic_compare_exchange_n(                                                               \
+            (ptr), (expected), (desired), 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE                    \
+        )
 #endif
 
 #endif /* _M3C_INCGUARD_BABEL_H */
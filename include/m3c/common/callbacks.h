@@ -5,4 +5,27 @@
 
 typedef void *(*M3C_ReallocCB)(void *ptr, m3c_size_t new_size);
 
+/**
+ * \brief Allocates at least `size` bytes of zeroed, page-aligned memory directly from the system.
+ *
+ * \return
+ * + on failure - `NULL`
+ * + on success - pointer to the beginning of the allocated memory
+ */
+typedef void *(*M3C_PageAllocCB)(m3c_size_t size);
+
+/**
+ * \brief Returns the memory allocated by #M3C_PageAllocCB to the system.
+ *
+ * \details `size` must be the same as passed to #M3C_PageAllocCB.
+ */
+typedef void (*M3C_PageFreeCB)(void *ptr, m3c_size_t size);
+
+/**
+ * \brief Thread procedure.
+ *
+ * \return thread exit code
+ */
+typedef int (*M3C_ThreadProcCB)(void *arg);
+
 #endif /* _M3C_INCGUARD_CALLBACKS_H */
@@ -32,7 +32,11 @@ typedef enum __tagM3C_ERROR {
     /**
      * \brief Out Of Bounds.
      */
-    M3C_ERROR_OOB = 6
+    M3C_ERROR_OOB = 6,
+    /**
+     * \brief Input/Output error (e.g., the file can't be opened or mapped).
+     */
+    M3C_ERROR_IO = 7
 } M3C_ERROR;
 
 #endif /* _M3C_INCGUARD_ERRORS_H */
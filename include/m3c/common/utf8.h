@@ -48,6 +48,40 @@ typedef m3c_u8 M3C_UTF8cu;
  */
 #define M3C_UTF8_ERR 1
 
+/**
+ * \brief Maximum length of UTF-8 sequence with `lead` as the first byte.
+ *
+ * \warning It's the length of a code point only if the buffer is known to be valid (see
+ * #M3C_UTF8ValidateBuffer) and `lead` is the first byte of the code point.
+ */
+#define M3C_UTF8_LEAD_BLEN(lead) ((lead) < 0x80 ? 1 : (lead) < 0xE0 ? 2 : (lead) < 0xF0 ? 3 : 4)
+
+/**
+ * \brief Selects the fastest implementation of #M3C_UTF8ValidateBuffer for the current CPU.
+ *
+ * \details On x86-64 it uses AVX2 version if the CPU supports it (SSE2 version otherwise). On other
+ * architectures byte-at-a-time version is always used.
+ *
+ * \note It's safe to call #M3C_UTF8ValidateBuffer before this function (and without it at all).
+ *
+ * \warning This function is not thread-safe! It should be called once at the start of the program.
+ */
+void M3C_UTF8_Init(void);
+
+/**
+ * \brief Checks the validity of the whole buffer.
+ *
+ * \details Does the same checks as #M3C_UTF8ValidateCodepoint for each code point, but whole
+ * vectors at once (where possible).
+ *
+ * \param[in]  ptr     a pointer to first code unit in buffer
+ * \param[in]  last    a pointer to the last code unit in the buffer or, if the buffer is empty, to
+ * something with an address lesser than `ptr`. Can be `NULL`
+ * \param[out] isASCII writes here whether all code units are ASCII (only if the buffer is valid)
+ * \return #M3C_UTF8_OK or #M3C_UTF8_ERR
+ */
+int M3C_UTF8ValidateBuffer(const m3c_u8 *ptr, const m3c_u8 *last, m3c_bool *isASCII);
+
 /**
  * \brief Checks the validity of the first code point in the buffer.
  *
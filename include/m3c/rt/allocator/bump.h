@@ -15,6 +15,10 @@
  * the end of last allocation, reallocation allocates the new memory and copy the previous memory
  * content to the new location, and free is just a noop.
  *
+ * The only exception is the last allocated object (the *top* object). It's the only object that
+ * ends at the bump pointer, so reallocation resizes it in place and \ref
+ * M3C_BumpAllocator_FreeSized "FreeSized" rolls the bump pointer back to its start.
+ *
  * \warning This implementation is **not** thread-safe!
  *
  * \note \ref M3C_BumpAllocator_Alloc "Alloc", \ref M3C_BumpAllocator_Calloc "Calloc", and \ref
@@ -50,6 +54,9 @@
  *   - \ref M3C_BumpAllocator_Free "Free"
  *   - \ref M3C_BumpAllocator_FreeSized "FreeSized"
  *   - \ref M3C_BumpAllocator_FreeAlignedSized "FreeAlignedSized"
+ * + checkpoints (frees all objects allocated after the checkpoint at once)
+ *   - \ref M3C_BumpAllocator_Mark "Mark"
+ *   - \ref M3C_BumpAllocator_Release "Release"
  *
  * \note If the user is not interested in alignment, it is completely legal to use
  * different versions of functions (aligned and unaligned) to work with the same object (for example
@@ -58,6 +65,35 @@
  * which uses `1` as `alignment`), and finally free with \ref M3C_BumpAllocator_FreeAlignedSized
  * "FreeAlignedSized" with `alignment` not equal to `1`.
  */
+#ifdef M3C_FEATURE_ALLOC_STATS
+/**
+ * \brief Statistics of the bump allocator.
+ *
+ * \note Only available if `M3C_FEATURE_ALLOC_STATS` is defined.
+ */
+typedef struct __tagM3C_BumpAllocatorStats {
+    /**
+     * \brief Number of reallocations of the top object done in place.
+     */
+    m3c_size_t inPlaceReallocs;
+    /**
+     * \brief Number of reallocations that allocated the new object and copied the old one.
+     */
+    m3c_size_t copyingReallocs;
+    /**
+     * \brief Number of bytes copied by reallocations.
+     *
+     * \details As the old objects can't be freed, it's also the number of bytes wasted by dead
+     * copies.
+     */
+    m3c_size_t copiedBytes;
+    /**
+     * \brief Number of bytes wasted for alignment padding.
+     */
+    m3c_size_t paddingBytes;
+} M3C_BumpAllocatorStats;
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
 typedef struct __tagM3C_BumpAllocator {
     /**
      * \brief Pointer to the first byte in the buffer.
@@ -80,8 +116,43 @@ typedef struct __tagM3C_BumpAllocator {
      * \brief Pointer to the last byte in the buffer.
      */
     void *last;
+    /**
+     * \brief Pointer to the first byte of the last allocated object.
+     *
+     * \details The object occupies all bytes from this pointer up to the \ref
+     * M3C_BumpAllocator::ptr "bump pointer".
+     *
+     * \note Is `NULL` if it's unknown (e.g. right after the top object has been freed).
+     */
+    void *top;
+#ifdef M3C_FEATURE_ALLOC_STATS
+    /**
+     * \brief Statistics.
+     */
+    M3C_BumpAllocatorStats stats;
+#endif /* M3C_FEATURE_ALLOC_STATS */
 } M3C_BumpAllocator;
 
+/**
+ * \brief Checkpoint of the bump allocator.
+ *
+ * \sa \ref M3C_BumpAllocator_Mark "Mark", \ref M3C_BumpAllocator_Release "Release"
+ */
+typedef struct __tagM3C_BumpAllocatorMark {
+    /**
+     * \brief \ref M3C_BumpAllocator::first "first" at the moment of the checkpoint.
+     */
+    void *first;
+    /**
+     * \brief \ref M3C_BumpAllocator::ptr "Bump pointer" at the moment of the checkpoint.
+     */
+    void *ptr;
+    /**
+     * \brief \ref M3C_BumpAllocator::last "last" at the moment of the checkpoint.
+     */
+    void *last;
+} M3C_BumpAllocatorMark;
+
 /**
  * \brief Inits the bump allocator.
  *
@@ -293,9 +364,10 @@ void *M3C_BumpAllocator_CallocAligned(
  *
  * If there is not enough memory, the old memory block is not freed and `NULL` is returned.
  *
- * \note \ref M3C_BumpAllocator "BumpAllocator" can't truly free the old memory so it simply
- * allocates the new memory and copies the content of old memory to the newly allocated location.
- * This function is provided for compatibility.
+ * \note If `ptr` is the last allocated object (and it's aligned to `alignment`), it is resized in
+ * place. Otherwise, as \ref M3C_BumpAllocator "BumpAllocator" can't truly free the old memory, it
+ * simply allocates the new memory and copies the content of old memory to the newly allocated
+ * location.
  *
  * \note If the user is not interested in alignment, it is completely legal to use different
  * versions of functions (aligned and unaligned) to work with the same object.
@@ -330,9 +402,10 @@ void *M3C_BumpAllocator_ReallocAligned(
  *
  * If there is not enough memory, the old memory block is not freed and `NULL` is returned.
  *
- * \note \ref M3C_BumpAllocator "BumpAllocator" can't truly free the old memory so it simply
- * allocates the new memory and copies the content of old memory to the newly allocated location.
- * This function is provided for compatibility.
+ * \note If `ptr` is the last allocated object (and it's aligned to `alignment`), it is resized in
+ * place. Otherwise, as \ref M3C_BumpAllocator "BumpAllocator" can't truly free the old memory, it
+ * simply allocates the new memory and copies the content of old memory to the newly allocated
+ * location.
  *
  * \note If the user is not interested in alignment, it is completely legal to use different
  * versions of functions (aligned and unaligned) to work with the same object.
@@ -367,9 +440,10 @@ void *M3C_BumpAllocator_ReallocAligned(
  *
  * If there is not enough memory, the old memory block is not freed and `NULL` is returned.
  *
- * \note \ref M3C_BumpAllocator "BumpAllocator" can't truly free the old memory so it simply
- * allocates the new memory and copies the content of old memory to the newly allocated location.
- * This function is provided for compatibility.
+ * \note If `ptr` is the last allocated object (and it's aligned to `alignment`), it is resized in
+ * place. Otherwise, as \ref M3C_BumpAllocator "BumpAllocator" can't truly free the old memory, it
+ * simply allocates the new memory and copies the content of old memory to the newly allocated
+ * location.
  *
  * \note If the user is not interested in alignment, it is completely legal to use different
  * versions of functions (aligned and unaligned) to work with the same object.
@@ -400,20 +474,64 @@ void *M3C_BumpAllocator_ReallocAligned(
 #define M3C_BumpAllocator_Free(ba, ptr) /* noop */
 
 /**
- * \brief Noop.
+ * \brief Deallocates the object if it's the last one.
  *
- * \note \ref M3C_BumpAllocator "BumpAllocator" can't truly deallocate so this macro is a noop
- * provided for compatibility.
+ * \details If the object ends at the bump pointer (so it's the last allocated object), the bump
+ * pointer is rolled back to the start of the object and its memory can be allocated again.
+ * Otherwise it's a noop.
+ *
+ * \note As the object is recognised by its end, objects freed in the reverse order of allocation
+ * are all rolled back (unless there is an alignment padding between them).
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] ba   bump allocator
+ * \param         ptr  pointer to the memory to deallocate. May be `NULL` (noop)
+ * \param         size size of the object in bytes (as it was passed to the last `Alloc` or
+ * `Realloc` call for this object)
  */
-#define M3C_BumpAllocator_FreeSized(ba, ptr, size) M3C_BumpAllocator_Free((ba), (ptr))
+void M3C_BumpAllocator_FreeSized(M3C_BumpAllocator *ba, void *ptr, m3c_size_t size);
 
 /**
- * \brief Noop.
+ * \brief Deallocates the object if it's the last one.
  *
- * \note \ref M3C_BumpAllocator "BumpAllocator" can't truly deallocate so this macro is a noop
- * provided for compatibility.
+ * \details It's a wrapper over function \ref M3C_BumpAllocator_FreeSized "FreeSized". The
+ * `alignment` is ignored.
  */
 #define M3C_BumpAllocator_FreeAlignedSized(ba, ptr, alignment, size)                               \
-    M3C_BumpAllocator_Free((ba), (ptr))
+    M3C_BumpAllocator_FreeSized((ba), (ptr), (size))
+
+/**
+ * \brief Makes a checkpoint.
+ *
+ * \details All objects allocated after the checkpoint can be freed at once with \ref
+ * M3C_BumpAllocator_Release "Release".
+ *
+ * \note The top object is forgotten, so objects allocated before the checkpoint never grow in
+ * place over it.
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] ba bump allocator
+ *
+ * \return checkpoint
+ */
+M3C_BumpAllocatorMark M3C_BumpAllocator_Mark(M3C_BumpAllocator *ba);
+
+/**
+ * \brief Frees all objects allocated after the checkpoint.
+ *
+ * \details Rolls the bump pointer back to the checkpoint. Checkpoints made after this one become
+ * invalid.
+ *
+ * \note If the buffer was replaced (or extended) after the checkpoint, the buffer of the checkpoint
+ * is restored. The allocator doesn't use the later buffers anymore, so their owner can reuse them.
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] ba   bump allocator
+ * \param         mark checkpoint made by \ref M3C_BumpAllocator_Mark "Mark" of the same allocator
+ */
+void M3C_BumpAllocator_Release(M3C_BumpAllocator *ba, M3C_BumpAllocatorMark mark);
 
 #endif /* _M3C_INCGUARD_RT_ALLOCATOR_BUMP_H */
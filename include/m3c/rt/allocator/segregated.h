@@ -0,0 +1,306 @@
+#ifndef _M3C_INCGUARD_RT_ALLOCATOR_SEGREGATED_H
+#define _M3C_INCGUARD_RT_ALLOCATOR_SEGREGATED_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/babel.h>
+#include <m3c/common/callbacks.h>
+#include <m3c/rt/allocator/bump.h>
+
+#ifdef M3C_FUNDAMENTAL_ALIGN
+
+/**
+ * \brief Size of the smallest size class in bytes.
+ *
+ * \note Must be a power of two and not less than `sizeof(void *)` as free blocks store the free
+ * list link in their payload.
+ */
+#    define M3C_SEGREGATED_MIN_CLASS_SIZE 16
+
+/**
+ * \brief Number of size classes.
+ *
+ * \details Size classes are the powers of two from #M3C_SEGREGATED_MIN_CLASS_SIZE up to
+ * #M3C_SEGREGATED_MAX_CLASS_SIZE (both inclusive).
+ */
+#    define M3C_SEGREGATED_CLASSES 14
+
+/**
+ * \brief Size of the largest size class in bytes.
+ *
+ * \details Objects greater than this size are *large objects*. They are not taken from the
+ * backing \ref M3C_BumpAllocator "BumpAllocator" but are allocated and freed directly with \ref
+ * M3C_SegregatedAllocator::largeAlloc "largeAlloc" and \ref M3C_SegregatedAllocator::largeFree
+ * "largeFree" callbacks.
+ */
+#    define M3C_SEGREGATED_MAX_CLASS_SIZE                                                          \
+        ((m3c_size_t)M3C_SEGREGATED_MIN_CLASS_SIZE << (M3C_SEGREGATED_CLASSES - 1))
+
+/**
+ * \brief Size of the object header in bytes.
+ *
+ * \details Each object is preceded by a header that stores the object capacity. The header
+ * occupies *fundamental alignment* bytes so the object itself stays aligned.
+ */
+#    define M3C_SEGREGATED_HEADER_SIZE                                                             \
+        (M3C_FUNDAMENTAL_ALIGN > sizeof(m3c_size_t) ? M3C_FUNDAMENTAL_ALIGN : sizeof(m3c_size_t))
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+/**
+ * \brief Number of buckets in the allocation-size histogram.
+ *
+ * \details Bucket `0` counts zero-sized allocations, bucket `i` counts allocations of `2^(i-1) + 1`
+ * to `2^i` bytes (bucket `1` also counts 1-byte allocations). The last bucket counts all greater
+ * allocations.
+ */
+#        define M3C_SEGREGATED_STATS_BUCKETS 32
+
+/**
+ * \brief Statistics of the segregated-fit allocator.
+ *
+ * \note Only available if `M3C_FEATURE_ALLOC_STATS` is defined.
+ */
+typedef struct __tagM3C_SegregatedAllocatorStats {
+    /**
+     * \brief Number of allocations.
+     *
+     * \note Reallocations are not counted.
+     */
+    m3c_size_t allocs;
+    /**
+     * \brief Number of bytes requested by allocations.
+     */
+    m3c_size_t allocatedBytes;
+    /**
+     * \brief Number of reallocations (not including ones with `NULL` as the object).
+     */
+    m3c_size_t reallocs;
+    /**
+     * \brief Number of reallocations that moved the object.
+     */
+    m3c_size_t copyingReallocs;
+    /**
+     * \brief Number of bytes copied by reallocations.
+     */
+    m3c_size_t copiedBytes;
+    /**
+     * \brief Number of deallocations.
+     */
+    m3c_size_t frees;
+    /**
+     * \brief Number of bytes occupied by live objects (capacities including headers).
+     */
+    m3c_size_t liveBytes;
+    /**
+     * \brief High-water mark of \ref M3C_SegregatedAllocatorStats::liveBytes "liveBytes".
+     */
+    m3c_size_t peakLiveBytes;
+    /**
+     * \brief Allocation-size histogram (see #M3C_SEGREGATED_STATS_BUCKETS).
+     */
+    m3c_size_t histogram[M3C_SEGREGATED_STATS_BUCKETS];
+} M3C_SegregatedAllocatorStats;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+/**
+ * \brief Segregated-fit allocator.
+ *
+ * \details Rounds every request up to a power-of-two *size class* and keeps an intrusive singly
+ * linked free list per class. Allocation pops the free list of the class and only bumps the
+ * backing \ref M3C_BumpAllocator "BumpAllocator" if the list is empty. Deallocation pushes the
+ * object back to its list, so the memory is reused by later allocations of the same class.
+ *
+ * *Large objects* (see #M3C_SEGREGATED_MAX_CLASS_SIZE) bypass the size classes and are returned
+ * to the system as soon as they are freed.
+ *
+ * Unlike \ref M3C_BumpAllocator "BumpAllocator", the allocator knows the capacity of each object
+ * (it is stored in the object header), so \ref M3C_SegregatedAllocator_Realloc "Realloc" copies
+ * only the live bytes and does nothing if the new size still fits in the capacity.
+ *
+ * \warning This implementation is **not** thread-safe!
+ *
+ * \note All objects are aligned to *fundamental alignment*.
+ *
+ * Interface:
+ * + new
+ *   - \ref M3C_SegregatedAllocator_New "New"
+ * + allocation
+ *   - \ref M3C_SegregatedAllocator_Alloc "Alloc"
+ * + reallocation
+ *   - \ref M3C_SegregatedAllocator_Realloc "Realloc"
+ * + deallocation
+ *   - \ref M3C_SegregatedAllocator_Free "Free"
+ * + checkpoints (frees all objects allocated after the checkpoint at once)
+ *   - \ref M3C_SegregatedAllocator_Mark "Mark"
+ *   - \ref M3C_SegregatedAllocator_Release "Release"
+ */
+typedef struct __tagM3C_SegregatedAllocator {
+    /**
+     * \brief Backing allocator for objects of all size classes.
+     *
+     * \note Must not be `NULL`.
+     */
+    M3C_BumpAllocator *backing;
+    /**
+     * \brief Heads of the free lists (one for each size class).
+     *
+     * \details The first pointer-sized word of each free object points to the next free object of
+     * the same size class (or is `NULL`).
+     */
+    void *freeLists[M3C_SEGREGATED_CLASSES];
+    /**
+     * \brief Allocates memory for a large object.
+     *
+     * \note Can be `NULL`. In this case large objects can't be allocated.
+     */
+    M3C_PageAllocCB largeAlloc;
+    /**
+     * \brief Frees memory allocated by \ref M3C_SegregatedAllocator::largeAlloc "largeAlloc".
+     *
+     * \note Can be `NULL` if \ref M3C_SegregatedAllocator::largeAlloc "largeAlloc" is `NULL`.
+     */
+    M3C_PageFreeCB largeFree;
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    /**
+     * \brief Statistics.
+     */
+    M3C_SegregatedAllocatorStats stats;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+} M3C_SegregatedAllocator;
+
+/**
+ * \brief Checkpoint of the segregated-fit allocator.
+ *
+ * \sa \ref M3C_SegregatedAllocator_Mark "Mark", \ref M3C_SegregatedAllocator_Release "Release"
+ */
+typedef struct __tagM3C_SegregatedAllocatorMark {
+    /**
+     * \brief Checkpoint of the backing allocator.
+     */
+    M3C_BumpAllocatorMark backing;
+    /**
+     * \brief Free lists at the moment of the checkpoint.
+     */
+    void *freeLists[M3C_SEGREGATED_CLASSES];
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    /**
+     * \brief \ref M3C_SegregatedAllocatorStats::liveBytes "Live bytes" at the moment of the
+     * checkpoint.
+     */
+    m3c_size_t liveBytes;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+} M3C_SegregatedAllocatorMark;
+
+/**
+ * \brief Inits the segregated-fit allocator.
+ *
+ * \param[in,out] sa         segregated-fit allocator
+ * \param[in]     backing    backing allocator for size classes. Must not be `NULL`
+ * \param         largeAlloc callback to allocate large objects. Can be `NULL`
+ * \param         largeFree  callback to free large objects. Can be `NULL` only if `largeAlloc` is
+ * `NULL`
+ */
+void M3C_SegregatedAllocator_New(
+    M3C_SegregatedAllocator *sa, M3C_BumpAllocator *backing, M3C_PageAllocCB largeAlloc,
+    M3C_PageFreeCB largeFree
+);
+
+/**
+ * \brief Allocates `size` bytes of uninitialized storage with *fundamental alignment*.
+ *
+ * \note If `size` is zero, it will still try to allocate memory (of the smallest size class). But
+ * the resulting pointer should not be dereferenced.
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] sa   segregated-fit allocator
+ * \param         size number of bytes to allocate. May be zero
+ *
+ * \return
+ * + on failure - `NULL`
+ * + on success - pointer to the beginning of newly allocated memory
+ */
+void *M3C_SegregatedAllocator_Alloc(M3C_SegregatedAllocator *sa, m3c_size_t size);
+
+/**
+ * \brief Reallocates the given area of memory.
+ *
+ * \details If `ptr` is not `NULL`, it must be previously allocated by \ref
+ * M3C_SegregatedAllocator_Alloc "Alloc" or \ref M3C_SegregatedAllocator_Realloc "Realloc" of the
+ * same allocator and not yet freed or reallocated. If `ptr` is `NULL`, the behavior is the same as
+ * calling `Alloc(sa, new_size)`.
+ *
+ * If `new_size` fits in the capacity of the object, the object is not moved and `ptr` is returned.
+ * If the object is the last one allocated from the backing allocator, it grows in place.
+ * Otherwise, the new object is allocated, the content of the old object is copied to it and the
+ * old object is freed.
+ *
+ * If there is not enough memory, the old memory block is not freed and `NULL` is returned.
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] sa       segregated-fit allocator
+ * \param         ptr      pointer to the memory area to be reallocated. May be `NULL`
+ * \param         new_size new size of the array in bytes. May be `0`
+ *
+ * \return
+ * + on failure - `NULL`
+ * + on success - pointer to the beginning of reallocated memory
+ */
+void *M3C_SegregatedAllocator_Realloc(M3C_SegregatedAllocator *sa, void *ptr, m3c_size_t new_size);
+
+/**
+ * \brief Deallocates the space previously allocated by \ref M3C_SegregatedAllocator_Alloc "Alloc"
+ * or \ref M3C_SegregatedAllocator_Realloc "Realloc".
+ *
+ * \details Objects of size classes are pushed to the free list of their class (or returned to the
+ * backing allocator if it's the last object allocated from it). Large objects are returned with
+ * \ref M3C_SegregatedAllocator::largeFree "largeFree".
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] sa  segregated-fit allocator
+ * \param         ptr pointer to the memory to deallocate. May be `NULL` (noop)
+ */
+void M3C_SegregatedAllocator_Free(M3C_SegregatedAllocator *sa, void *ptr);
+
+/**
+ * \brief Makes a checkpoint.
+ *
+ * \details All objects of size classes allocated after the checkpoint can be freed at once with
+ * \ref M3C_SegregatedAllocator_Release "Release".
+ *
+ * The free lists are set aside until the release, so the objects freed before the checkpoint are
+ * not reused by the objects allocated after it.
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] sa   segregated-fit allocator
+ * \param[out]    mark checkpoint
+ */
+void M3C_SegregatedAllocator_Mark(M3C_SegregatedAllocator *sa, M3C_SegregatedAllocatorMark *mark);
+
+/**
+ * \brief Frees all objects of size classes allocated after the checkpoint.
+ *
+ * \details Restores the free lists and rolls the backing allocator back to the checkpoint.
+ * Checkpoints made after this one become invalid.
+ *
+ * \note Large objects are not freed by the release, they must be freed explicitly. Objects
+ * allocated before the checkpoint but freed after it are not reused anymore.
+ *
+ * \note \ref M3C_SegregatedAllocatorStats::liveBytes "Live bytes" are restored to the value at the
+ * checkpoint (so large objects allocated after it are not counted anymore).
+ *
+ * \warning This implementation is not thread-safe!
+ *
+ * \param[in,out] sa   segregated-fit allocator
+ * \param[in]     mark checkpoint made by \ref M3C_SegregatedAllocator_Mark "Mark" of the same
+ * allocator
+ */
+void M3C_SegregatedAllocator_Release(
+    M3C_SegregatedAllocator *sa, const M3C_SegregatedAllocatorMark *mark
+);
+
+#endif /* M3C_FUNDAMENTAL_ALIGN */
+
+#endif /* _M3C_INCGUARD_RT_ALLOCATOR_SEGREGATED_H */
@@ -0,0 +1,10 @@
+#ifndef _M3C_INCGUARD_RT_FILE_H
+#define _M3C_INCGUARD_RT_FILE_H
+
+#include <m3c/common/env.h>
+
+#ifdef M3C_KERNEL_LINUX
+#    include <m3c/rt/linux/file.h>
+#endif /* M3C_KERNEL_LINUX */
+
+#endif /* _M3C_INCGUARD_RT_FILE_H */
@@ -0,0 +1,49 @@
+#ifndef _M3C_INCGUARD_RT_LINUX_FILE_H
+#define _M3C_INCGUARD_RT_LINUX_FILE_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/errors.h>
+
+/**
+ * \brief Read-only mapping of a file.
+ *
+ * \sa #M3C_File_Map
+ */
+typedef struct __tagM3C_FileMapping {
+    /**
+     * \brief Pointer to the first byte of the file.
+     *
+     * \note Never `NULL` (even if the file is empty).
+     */
+    m3c_u8 const *ptr;
+    /**
+     * \brief File size in bytes.
+     */
+    m3c_size_t len;
+} M3C_FileMapping;
+
+/**
+ * \brief Maps the whole file into memory (read-only).
+ *
+ * \details The file is mapped privately, so later changes of the file don't affect the mapping
+ * (until the page is read). The mapping is advised to be read sequentially.
+ *
+ * \note Empty files are not mapped at all, #M3C_FileMapping::ptr points to a static empty buffer.
+ *
+ * \param[in]  path    path to the file (null-terminated)
+ * \param[out] mapping file mapping
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_IO - if the file can't be opened, stat'ed or mapped
+ */
+M3C_ERROR M3C_File_Map(char const *path, M3C_FileMapping *mapping);
+
+/**
+ * \brief Unmaps the file mapped by #M3C_File_Map.
+ *
+ * \param[in] mapping file mapping
+ */
+void M3C_File_Unmap(M3C_FileMapping const *mapping);
+
+#endif /* _M3C_INCGUARD_RT_LINUX_FILE_H */
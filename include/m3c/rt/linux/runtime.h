@@ -1,7 +1,9 @@
 #ifndef _M3C_INCGUARD_RT_LINUX_RUNTIME_H
 #define _M3C_INCGUARD_RT_LINUX_RUNTIME_H
 
+#include <m3c/common/callbacks.h>
 #include <m3c/rt/syscalls.h>
+#include <m3c/rt/allocator/segregated.h>
 
 /**
  * \brief Number of bytes in one kibibyte.
@@ -11,22 +13,221 @@
 /**
  * \brief Number of bytes in one mebibyte.
  */
-#define M3C_MiB M3C_KiB * 1024
+#define M3C_MiB (M3C_KiB * 1024)
 
 /**
  * \brief Number of bytes in one gibibyte.
  */
-#define M3C_GiB M3C_MiB * 1024
+#define M3C_GiB (M3C_MiB * 1024)
+
+/**
+ * \brief Environment variable with the size of the heap address space (in bytes).
+ *
+ * \details The value is a decimal number with an optional `K`, `M` or `G` suffix (e.g. `16G`). The
+ * address space is only reserved, the memory is committed by chunks as the heap grows.
+ */
+#define M3C_RUNTIME_ENV_HEAP_SIZE "M3C_HEAP_SIZE"
+
+/**
+ * \brief Environment variable with the huge-page policy of the heap.
+ *
+ * \details If it's set to `0`, the heap is not backed by transparent huge pages. Otherwise, the
+ * heap is marked with `MADV_HUGEPAGE`.
+ */
+#define M3C_RUNTIME_ENV_HEAP_HUGEPAGES "M3C_HEAP_HUGEPAGES"
+
+/**
+ * \brief Environment of the process.
+ *
+ * \details `NULL`-terminated array of `NAME=value` strings. Set by the start routine before `main`
+ * is called.
+ */
+extern char **__m3c_envp;
 
 /**
  * \brief Inits runtime.
  *
+ * \details Reserves the heap address space (see #M3C_RUNTIME_ENV_HEAP_SIZE and
+ * #M3C_RUNTIME_ENV_HEAP_HUGEPAGES) and commits the first chunk of it.
+ *
  * \return
  * + on success - zero
  * + on error - negative number
  */
 int M3C_Runtime_New(void);
 
+/**
+ * \brief Runtime thread.
+ *
+ * \details Each thread has its own arena: a range of the heap with its own allocator. So threads
+ * allocate without any locks. Arenas are refilled from the ranges returned by joined threads or, if
+ * there is no such range, from the heap with an atomic bump.
+ *
+ * \warning Objects must be freed by the thread that allocated them (another thread would put them
+ * to its own free lists, which outlive the arena of the allocating thread).
+ */
+typedef struct __tagM3C_RuntimeThread M3C_RuntimeThread;
+
+/**
+ * \brief Spawns the new thread.
+ *
+ * \warning Runtime must be inited (see #M3C_Runtime_New).
+ *
+ * \param proc thread procedure
+ * \param arg  argument of the thread procedure
+ *
+ * \return
+ * + on error - `NULL`
+ * + on success - thread handle (it must be joined with #M3C_Runtime_JoinThread)
+ */
+M3C_RuntimeThread *M3C_Runtime_SpawnThread(M3C_ThreadProcCB proc, void *arg);
+
+/**
+ * \brief Waits for the thread to finish and frees its stack and arena.
+ *
+ * \details The ranges of the heap claimed by the thread arena are returned to the runtime, so the
+ * arenas of other threads (including the ones spawned later) are refilled from them.
+ *
+ * \note Large objects (see #M3C_SEGREGATED_MAX_CLASS_SIZE) are not in the arena, they must be
+ * freed explicitly.
+ *
+ * \warning Objects allocated by the thread become invalid. Everything the caller needs must be
+ * copied before the thread finishes.
+ *
+ * \param[in,out] thread thread handle returned by #M3C_Runtime_SpawnThread
+ *
+ * \return result of the thread procedure
+ */
+int M3C_Runtime_JoinThread(M3C_RuntimeThread *thread);
+
+/**
+ * \brief Blocks the calling thread while the word equals `value`.
+ *
+ * \details Together with #M3C_Runtime_Signal it's a minimal way for threads to wait for each
+ * other (e.g. for the spawner to take the results of a thread before it finishes).
+ *
+ * \param[in] word  word shared by the threads
+ * \param     value value to wait out
+ */
+void M3C_Runtime_Wait(int *word, int value);
+
+/**
+ * \brief Sets the word to `value` and wakes all threads waiting on it (see #M3C_Runtime_Wait).
+ *
+ * \param[out] word  word shared by the threads
+ * \param      value new value
+ */
+void M3C_Runtime_Signal(int *word, int value);
+
+/**
+ * \brief Range of the heap claimed by a thread arena (or free to be claimed again).
+ *
+ * \details The descriptor is stored in the first bytes of the range itself.
+ */
+typedef struct __tagM3C_RuntimeRange M3C_RuntimeRange;
+
+/**
+ * \brief Allocation scope.
+ *
+ * \details Objects allocated by the thread inside the scope are freed at once when the scope is
+ * left. It's useful for temporary data of a whole phase.
+ *
+ * \sa #M3C_Runtime_EnterScope, #M3C_Runtime_LeaveScope
+ */
+typedef struct __tagM3C_RuntimeScope {
+    /**
+     * \brief Checkpoint of the thread allocator.
+     */
+    M3C_SegregatedAllocatorMark mark;
+    /**
+     * \brief Current range of the thread arena at the moment of the scope.
+     */
+    M3C_RuntimeRange *range;
+    /**
+     * \brief Size of \ref M3C_RuntimeScope::range "range" at the moment of the scope.
+     */
+    m3c_size_t rangeSize;
+} M3C_RuntimeScope;
+
+/**
+ * \brief Enters the allocation scope.
+ *
+ * \details Scopes may be nested, but they must be left in the reverse order and by the same
+ * thread.
+ *
+ * \param[out] scope scope
+ */
+void M3C_Runtime_EnterScope(M3C_RuntimeScope *scope);
+
+/**
+ * \brief Leaves the allocation scope and frees all objects allocated by the thread inside it.
+ *
+ * \details The ranges of the heap the thread arena claimed inside the scope are returned to the
+ * runtime, so the memory the thread uses is bounded by its largest scope (e.g. a batch of files,
+ * each lexed in its own scope, needs the memory of the largest file).
+ *
+ * \note Large objects (see #M3C_SEGREGATED_MAX_CLASS_SIZE) are not freed, they must be freed
+ * explicitly.
+ *
+ * \warning No object allocated inside the scope may be used after it.
+ *
+ * \param[in] scope scope entered with #M3C_Runtime_EnterScope
+ */
+void M3C_Runtime_LeaveScope(const M3C_RuntimeScope *scope);
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+/**
+ * \brief Allocation statistics of the runtime.
+ *
+ * \note Only available if `M3C_FEATURE_ALLOC_STATS` is defined.
+ *
+ * \sa #M3C_Runtime_GetStats
+ */
+typedef struct __tagM3C_RuntimeStats {
+    /**
+     * \brief Size of the reserved heap address space.
+     */
+    m3c_size_t heapSize;
+    /**
+     * \brief Number of bytes of the heap claimed by thread arenas.
+     *
+     * \details Ranges returned by joined threads and left scopes are reused before the heap grows,
+     * so it's the high-water mark of the heap.
+     */
+    m3c_size_t heapClaimed;
+    /**
+     * \brief Statistics of thread allocators.
+     *
+     * \note High-water marks of threads are summed, so it's an upper bound.
+     */
+    M3C_SegregatedAllocatorStats allocator;
+    /**
+     * \brief Statistics of thread arenas.
+     */
+    M3C_BumpAllocatorStats arena;
+} M3C_RuntimeStats;
+
+/**
+ * \brief Returns allocation statistics.
+ *
+ * \details Sums statistics of the main thread and all joined threads. Threads that are still
+ * running are not included.
+ *
+ * \note The statistics are also printed to `stderr` at exit.
+ *
+ * \param[out] stats statistics
+ */
+void M3C_Runtime_GetStats(M3C_RuntimeStats *stats);
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+/**
+ * \brief Finalizes runtime.
+ *
+ * \details Called by the start routine after `main` returns. Prints allocation statistics (if
+ * `M3C_FEATURE_ALLOC_STATS` is defined).
+ */
+void __M3C_Runtime_AtExit(void);
+
 void *__M3C_Runtime_Malloc(m3c_size_t size);
 
 void *__M3C_Runtime_Realloc(void *ptr, m3c_size_t new_size);
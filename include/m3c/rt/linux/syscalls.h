@@ -10,6 +10,12 @@
 /* some headers for convenient syscalls use */
 #include <fcntl.h>    /* for open */
 #include <sys/mman.h> /* for mmap */
+#include <sys/stat.h> /* for fstat (`struct stat` matches the kernel one) */
+/* NOTE: `MAP_ANONYMOUS`, `MADV_*` are not exposed by <sys/mman.h> in strict ISO C mode */
+#include <linux/mman.h>
+#include <linux/futex.h> /* for futex */
+#include <linux/sched.h> /* for clone flags */
+#include <asm/prctl.h>   /* for arch_prctl codes */
 
 /**
  * \brief Checks if result returned from syscall is an error.
@@ -136,6 +142,55 @@ int m3c_syscall_open(const char *path, int flags);
 int m3c_syscall_close(int fd);
 #endif /* SYS_close */
 
+#ifdef SYS_write
+/**
+ * \brief Raw wrapper for `write` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/write.2.html
+ *
+ * \param     fd    file descriptor
+ * \param[in] buf   buffer to write
+ * \param     count number of bytes to write
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - number of bytes written
+ */
+long m3c_syscall_write(int fd, const void *buf, long count);
+#endif /* SYS_write */
+
+#ifdef SYS_stat
+/**
+ * \brief Raw wrapper for `stat` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/stat.2.html
+ *
+ * \param[in]  path    path to the file
+ * \param[out] statbuf file status
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - `0`
+ */
+int m3c_syscall_stat(const char *path, struct stat *statbuf);
+#endif /* SYS_stat */
+
+#ifdef SYS_fstat
+/**
+ * \brief Raw wrapper for `fstat` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/fstat.2.html
+ *
+ * \param      fd      file descriptor
+ * \param[out] statbuf file status
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - `0`
+ */
+int m3c_syscall_fstat(int fd, struct stat *statbuf);
+#endif /* SYS_fstat */
+
 #ifdef SYS_mmap
 /**
  * \brief Raw wrapper for `mmap` syscall.
@@ -156,4 +211,121 @@ int m3c_syscall_close(int fd);
 void *m3c_syscall_mmap(void *addr, long length, int prot, int flags, int fd, long offset);
 #endif /* SYS_mmap */
 
+#ifdef SYS_munmap
+/**
+ * \brief Raw wrapper for `munmap` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/munmap.2.html
+ *
+ * \param addr   mapping address
+ * \param length mapping length
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - `0`
+ */
+int m3c_syscall_munmap(void *addr, long length);
+#endif /* SYS_munmap */
+
+#ifdef SYS_mprotect
+/**
+ * \brief Raw wrapper for `mprotect` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/mprotect.2.html
+ *
+ * \param addr   address (must be aligned to a page boundary)
+ * \param length length of the memory
+ * \param prot   memory protection flags
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - `0`
+ */
+int m3c_syscall_mprotect(void *addr, long length, int prot);
+#endif /* SYS_mprotect */
+
+#ifdef SYS_madvise
+/**
+ * \brief Raw wrapper for `madvise` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/madvise.2.html
+ *
+ * \param addr   address (must be aligned to a page boundary)
+ * \param length length of the memory
+ * \param advice advice
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - `0`
+ */
+int m3c_syscall_madvise(void *addr, long length, int advice);
+#endif /* SYS_madvise */
+
+#ifdef SYS_futex
+/**
+ * \brief Raw wrapper for `futex` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/futex.2.html
+ *
+ * \param[in,out] uaddr   futex word
+ * \param         op      operation
+ * \param         val     operation value
+ * \param[in]     timeout timeout (or `val2` for some operations). May be `NULL`
+ * \param[in,out] uaddr2  second futex word. May be `NULL`
+ * \param         val3    second operation value
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - depends on the operation
+ */
+long m3c_syscall_futex(int *uaddr, int op, int val, const void *timeout, int *uaddr2, int val3);
+#endif /* SYS_futex */
+
+#ifdef SYS_clone
+/**
+ * \brief Wrapper for `clone` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/clone.2.html
+ *
+ * Unlike other wrappers it takes the function to run in the child. The child starts on `stack`,
+ * calls `fn(arg)` and exits (the thread only) with its result. So it never returns from this
+ * function.
+ *
+ * \note It's implemented in assembly, as the child can't return to the caller frame when it runs
+ * on a different stack.
+ *
+ * \param         flags clone flags
+ * \param[in]     stack top of the child stack. Must not be `NULL`
+ * \param[out]    ptid  parent thread id location (for `CLONE_PARENT_SETTID`)
+ * \param[out]    ctid  child thread id location (for `CLONE_CHILD_SETTID`, `CLONE_CHILD_CLEARTID`)
+ * \param         tls   thread pointer (for `CLONE_SETTLS`)
+ * \param         fn    function to run in the child
+ * \param[in,out] arg   argument of `fn`
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - child thread id (in the parent)
+ */
+long M3C_SYSV_ABI m3c_syscall_clone(
+    unsigned long flags, void *stack, int *ptid, int *ctid, unsigned long tls, int (*fn)(void *),
+    void *arg
+);
+#endif /* SYS_clone */
+
+#ifdef SYS_arch_prctl
+/**
+ * \brief Raw wrapper for `arch_prctl` syscall.
+ *
+ * \details See https://man7.org/linux/man-pages/man2/arch_prctl.2.html
+ *
+ * \param code operation
+ * \param addr operation argument
+ *
+ * \return
+ * + on error - errno (see #M3C_IsRawErrno)
+ * + on success - `0`
+ */
+int m3c_syscall_arch_prctl(int code, unsigned long addr);
+#endif /* SYS_arch_prctl */
+
 #endif /* _M3C_INCGUARD_RT_LINUX_SYSCALLS_H */
@@ -20,13 +20,36 @@
 
 #    endif /* M3C_GNUC || M3C_CLANG */
 
+#    define M3C_Mem_Init() /* noop */
+
 #else /* M3C_FEATURE_USE_COMPILER_BUILTIN_FUNCTIONS */
 
+/**
+ * \brief Selects the fastest implementations of memory functions for the current CPU.
+ *
+ * \details On x86-64 it uses AVX2 versions if the CPU supports them (SSE2 versions otherwise). On
+ * other architectures word-at-a-time versions are always used.
+ *
+ * \note It's safe to call memory functions before this function (and without it at all). They will
+ * just use the default (not the fastest) implementations.
+ *
+ * \warning This function is not thread-safe! It should be called once at the start of the program.
+ */
+void M3C_Mem_Init(void);
+
 void *m3c_memcpy(void *m3c_restrict dest, const void *m3c_restrict src, size_t count);
 
+/**
+ * \brief Copies `count` bytes from `src` to `dest`. The buffers may overlap.
+ *
+ * \return `dest` buffer
+ */
+void *m3c_memmove(void *dest, const void *src, m3c_size_t count);
+
 void *m3c_memset(void *dest, int ch, m3c_size_t count);
 
 #    define memcpy(dest, src, count) m3c_memcpy((dest), (src), (count))
+#    define memmove(dest, src, count) m3c_memmove((dest), (src), (count))
 #    define memset(dest, ch, count) m3c_memset((dest), (ch), (count))
 
 #endif /* M3C_FEATURE_USE_COMPILER_BUILTIN_FUNCTIONS */
@@ -35,6 +58,10 @@ void *m3c_memset(void *dest, int ch, m3c_size_t count);
  * \brief Fills `dest` with the contents of `src`. The specified `len` and `count` parameters
  * determine the length and number of iterations of the copying process, respectively.
  *
+ * \details Patterns of 1, 2, 4 or 8 bytes are filled with the set kernels (as `m3c_memset`).
+ * Others are copied once and then the filled prefix of `dest` is copied after itself in doubling
+ * chunks.
+ *
  * \param[out] dest  buffer to be filled
  * \param[in]  src   buffer to be copied from
  * \param      len   length of `src`
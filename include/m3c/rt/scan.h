@@ -0,0 +1,64 @@
+#ifndef _M3C_INCGUARD_RT_SCAN_H
+#define _M3C_INCGUARD_RT_SCAN_H
+
+#include <m3c/common/types.h>
+
+/**
+ * \brief Selects the fastest implementations of scanning functions for the current CPU.
+ *
+ * \details On x86-64 it uses AVX2 versions if the CPU supports them (SSE2 versions otherwise). On
+ * other architectures byte-at-a-time versions are always used.
+ *
+ * \note It's safe to call scanning functions before this function (and without it at all). They
+ * will just use the default (not the fastest) implementations.
+ *
+ * \warning This function is not thread-safe! It should be called once at the start of the program.
+ */
+void M3C_Scan_Init(void);
+
+/**
+ * \brief Skips ASCII bytes except EOL (`\n` and `\r`).
+ *
+ * \param[in] ptr  pointer to the first byte
+ * \param[in] last pointer to the last byte (inclusive)
+ * \return pointer to the first EOL or non-ASCII byte or `last + 1` if there is no such byte
+ */
+m3c_u8 const *M3C_Scan_SkipText(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief Skips spaces and `\t`.
+ *
+ * \param[in] ptr  pointer to the first byte
+ * \param[in] last pointer to the last byte (inclusive)
+ * \return pointer to the first byte that is neither space nor `\t` or `last + 1` if there is no
+ * such byte
+ */
+m3c_u8 const *M3C_Scan_SkipBlanks(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief Finds EOL bytes (`\n` and `\r`).
+ *
+ * \details Finds them in bulk, so the caller can handle a batch of lines without calling this
+ * function for each one. To find the rest of EOLs call it again from the byte after the last found
+ * one.
+ *
+ * \param[in]  ptr  pointer to the first byte
+ * \param[in]  last pointer to the last byte (inclusive)
+ * \param[out] eols writes here pointers to the found EOL bytes (in ascending order)
+ * \param      maxN maximum number of EOL bytes to find (length of `eols`)
+ * \return number of found EOL bytes. If it's less than `maxN` then there are no EOL bytes left
+ */
+m3c_size_t M3C_Scan_FindEOLs(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+);
+
+/**
+ * \brief Counts EOLs (`\n`, `\r\n` and `\r`).
+ *
+ * \param[in] ptr  pointer to the first byte
+ * \param[in] last pointer to the last byte (inclusive)
+ * \return number of EOLs. `\r\n` is counted once
+ */
+m3c_size_t M3C_Scan_CountEOLs(m3c_u8 const *ptr, m3c_u8 const *last);
+
+#endif /* _M3C_INCGUARD_RT_SCAN_H */
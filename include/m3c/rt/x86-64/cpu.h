@@ -0,0 +1,38 @@
+#ifndef _M3C_INCGUARD_RT_X86_64_CPU_H
+#define _M3C_INCGUARD_RT_X86_64_CPU_H
+
+#include <m3c/common/env.h>
+#include <m3c/common/babel.h>
+
+#if defined(M3C_ARCH_X86_64) && defined(M3C_TARGET)
+
+/**
+ * \brief Defined if x86-64 SIMD code paths (and CPU feature detection) are available.
+ *
+ * \details SIMD code is written with compiler vector extensions and function \ref M3C_TARGET
+ * "target" attributes, so it doesn't need any intrinsics headers.
+ */
+#    define M3C_X86_64_SIMD 1
+
+/**
+ * \brief CPU supports SSE2.
+ *
+ * \note It's always set on x86-64.
+ */
+#    define M3C_CPU_FEATURE_SSE2 (1U << 0)
+
+/**
+ * \brief CPU supports AVX2 (and the OS saves YMM registers).
+ */
+#    define M3C_CPU_FEATURE_AVX2 (1U << 1)
+
+/**
+ * \brief Detects CPU features with `cpuid` instruction.
+ *
+ * \return bit set of `M3C_CPU_FEATURE_*` flags
+ */
+unsigned M3C_CPU_DetectFeatures(void);
+
+#endif /* M3C_ARCH_X86_64 && M3C_TARGET */
+
+#endif /* _M3C_INCGUARD_RT_X86_64_CPU_H */
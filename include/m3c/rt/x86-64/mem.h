@@ -0,0 +1,39 @@
+#ifndef _M3C_INCGUARD_RT_X86_64_MEM_H
+#define _M3C_INCGUARD_RT_X86_64_MEM_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/babel.h>
+#include <m3c/rt/x86-64/cpu.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/**
+ * \brief SSE2 version of `m3c_memcpy`.
+ */
+void *__M3C_Memcpy_SSE2(void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t count);
+
+/**
+ * \brief AVX2 version of `m3c_memcpy`.
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+void *__M3C_Memcpy_AVX2(void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t count);
+
+/**
+ * \brief Fills `count` bytes of `dest` with the repeated 8-byte `pattern` (SSE2 version).
+ *
+ * \details Byte `i` of `dest` is set to byte `i % 8` of the pattern (bytes of the pattern are
+ * counted from the least significant one).
+ */
+void *__M3C_MemsetPattern_SSE2(void *dest, unsigned long long pattern, m3c_size_t count);
+
+/**
+ * \brief AVX2 version of #__M3C_MemsetPattern_SSE2.
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+void *__M3C_MemsetPattern_AVX2(void *dest, unsigned long long pattern, m3c_size_t count);
+
+#endif /* M3C_X86_64_SIMD */
+
+#endif /* _M3C_INCGUARD_RT_X86_64_MEM_H */
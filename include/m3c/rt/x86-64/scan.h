@@ -0,0 +1,64 @@
+#ifndef _M3C_INCGUARD_RT_X86_64_SCAN_H
+#define _M3C_INCGUARD_RT_X86_64_SCAN_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/babel.h>
+#include <m3c/rt/x86-64/cpu.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/**
+ * \brief SSE2 version of #M3C_Scan_SkipText.
+ */
+m3c_u8 const *__M3C_Scan_SkipText_SSE2(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief AVX2 version of #M3C_Scan_SkipText.
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+m3c_u8 const *__M3C_Scan_SkipText_AVX2(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief SSE2 version of #M3C_Scan_SkipBlanks.
+ */
+m3c_u8 const *__M3C_Scan_SkipBlanks_SSE2(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief AVX2 version of #M3C_Scan_SkipBlanks.
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+m3c_u8 const *__M3C_Scan_SkipBlanks_AVX2(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief SSE2 version of #M3C_Scan_FindEOLs.
+ */
+m3c_size_t __M3C_Scan_FindEOLs_SSE2(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+);
+
+/**
+ * \brief AVX2 version of #M3C_Scan_FindEOLs.
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+m3c_size_t __M3C_Scan_FindEOLs_AVX2(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+);
+
+/**
+ * \brief SSE2 version of #M3C_Scan_CountEOLs.
+ */
+m3c_size_t __M3C_Scan_CountEOLs_SSE2(m3c_u8 const *ptr, m3c_u8 const *last);
+
+/**
+ * \brief AVX2 version of #M3C_Scan_CountEOLs.
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+m3c_size_t __M3C_Scan_CountEOLs_AVX2(m3c_u8 const *ptr, m3c_u8 const *last);
+
+#endif /* M3C_X86_64_SIMD */
+
+#endif /* _M3C_INCGUARD_RT_X86_64_SCAN_H */
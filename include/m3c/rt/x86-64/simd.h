@@ -0,0 +1,38 @@
+#ifndef _M3C_INCGUARD_RT_X86_64_SIMD_H
+#define _M3C_INCGUARD_RT_X86_64_SIMD_H
+
+#include <m3c/rt/x86-64/cpu.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/* NOTE: vectors of signed bytes, so non-ASCII bytes are negative */
+typedef signed char __M3C_I8x16 __attribute__((vector_size(16)));
+typedef signed char __M3C_I8x32 __attribute__((vector_size(32)));
+
+/* NOTE: vectors of unsigned bytes (for unsigned comparisons and shifts) */
+typedef unsigned char __M3C_U8x16 __attribute__((vector_size(16)));
+typedef unsigned char __M3C_U8x32 __attribute__((vector_size(32)));
+
+/* NOTE: vectors used for memory access. They are unaligned and may alias any object */
+typedef signed char __M3C_I8x16U __attribute__((vector_size(16), aligned(1), may_alias));
+typedef signed char __M3C_I8x32U __attribute__((vector_size(32), aligned(1), may_alias));
+typedef unsigned char __M3C_U8x32U __attribute__((vector_size(32), aligned(1), may_alias));
+
+/* NOTE: operand types of `pmovmskb` and `pshufb` builtins */
+typedef char __M3C_C8x16 __attribute__((vector_size(16)));
+typedef char __M3C_C8x32 __attribute__((vector_size(32)));
+
+/**
+ * \brief Gathers the most significant bits of vector bytes (`pmovmskb`).
+ */
+#    define __M3C_MOVEMASK_16(v) ((unsigned)__builtin_ia32_pmovmskb128((__M3C_C8x16)(v)))
+/**
+ * \brief As #__M3C_MOVEMASK_16 but for 32-byte vectors.
+ *
+ * \warning Requires AVX2.
+ */
+#    define __M3C_MOVEMASK_32(v) ((unsigned)__builtin_ia32_pmovmskb256((__M3C_C8x32)(v)))
+
+#endif /* M3C_X86_64_SIMD */
+
+#endif /* _M3C_INCGUARD_RT_X86_64_SIMD_H */
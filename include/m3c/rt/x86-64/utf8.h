@@ -0,0 +1,29 @@
+#ifndef _M3C_INCGUARD_RT_X86_64_UTF8_H
+#define _M3C_INCGUARD_RT_X86_64_UTF8_H
+
+#include <m3c/common/types.h>
+#include <m3c/common/babel.h>
+#include <m3c/rt/x86-64/cpu.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/**
+ * \brief SSE2 version of #M3C_UTF8ValidateBuffer.
+ *
+ * \details Skips ASCII vectors and validates the rest code point by code point.
+ */
+int __M3C_UTF8ValidateBuffer_SSE2(m3c_u8 const *ptr, m3c_u8 const *last, m3c_bool *isASCII);
+
+/**
+ * \brief AVX2 version of #M3C_UTF8ValidateBuffer.
+ *
+ * \details Validates whole vectors with lookup tables (the algorithm from "Validating UTF-8 In Less
+ * Than One Instruction Per Byte" by John Keiser and Daniel Lemire).
+ *
+ * \warning Must be called only if the CPU supports AVX2 (see #M3C_CPU_FEATURE_AVX2).
+ */
+int __M3C_UTF8ValidateBuffer_AVX2(m3c_u8 const *ptr, m3c_u8 const *last, m3c_bool *isASCII);
+
+#endif /* M3C_X86_64_SIMD */
+
+#endif /* _M3C_INCGUARD_RT_X86_64_UTF8_H */
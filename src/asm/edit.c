@@ -0,0 +1,614 @@
+#include <m3c/asm/edit.h>
+
+#include <m3c/common/coltypes.h>
+#include <m3c/common/macros.h>
+#include <m3c/common/utf8.h>
+
+#include <m3c/rt/alloc.h>
+#include <m3c/rt/file.h>
+#include <m3c/rt/mem.h>
+
+#include <m3c/asm/lex.h>
+#include <m3c/asm/lexer.h>
+#include <m3c/asm/tokens.h>
+
+typedef M3C_VEC(M3C_ASM_Fragment) M3C_ASM_Fragments;
+
+/**
+ * \brief State of applying an edit.
+ */
+typedef struct __tagM3C_ASM_Edit {
+    /**
+     * \brief Edited document (with the old buffer and caches).
+     */
+    M3C_ASM_Document *document;
+    /**
+     * \brief Edited document with the new buffer.
+     *
+     * \details Its \ref M3C_ASM_Document::tokens "tokens" and \ref M3C_ASM_Document::diagnostics
+     * "diagnostics" are only the ones lexed again.
+     */
+    M3C_ASM_Document relexed;
+    /**
+     * \brief Fragments split again.
+     */
+    M3C_ASM_Fragments fragments;
+    /**
+     * \brief Index of the first old fragment that is split again.
+     */
+    m3c_size_t firstFragment;
+    /**
+     * \brief Index of the first old fragment after the ones split again.
+     */
+    m3c_size_t lastFragment;
+    /**
+     * \brief Change of the lines of the fragments after the ones split again (modulo \f$2^{32}\f$).
+     */
+    m3c_u32 lineDelta;
+    /**
+     * \brief Index of the old fragment from which the tokens are lexed again.
+     */
+    m3c_size_t relexFragment;
+    /**
+     * \brief Handle of the first old token that is lexed again.
+     */
+    m3c_size_t firstToken;
+    /**
+     * \brief Handle of the first old token after the ones lexed again.
+     */
+    m3c_size_t lastToken;
+    /**
+     * \brief Whether the tokens are lexed again until EOF.
+     */
+    m3c_bool isLexedToEOF;
+    /**
+     * \brief Offset of the first replaced byte.
+     */
+    m3c_u32 start;
+    /**
+     * \brief Old offset of the byte after the replaced ones.
+     */
+    m3c_u32 end;
+    /**
+     * \brief New offset of the byte after the inserted ones.
+     */
+    m3c_u32 newEnd;
+    /**
+     * \brief Change of the offsets after the edit (modulo \f$2^{32}\f$, so it can be "negative").
+     */
+    m3c_u32 delta;
+} M3C_ASM_Edit;
+
+/**
+ * \brief Offset of the byte pointed by `PTR` in the buffer starting at `B_FIRST`.
+ */
+#define __M3C_ASM_EDIT_OFFSET(PTR, B_FIRST) ((m3c_u32)((PTR) - (B_FIRST)))
+
+/**
+ * \brief Checks that the byte continues an UTF-8 sequence.
+ */
+#define __M3C_ASM_EDIT_IS_CONTINUATION(BYTE) (((BYTE) & 0xC0) == 0x80)
+
+/**
+ * \brief Returns the index of the last fragment that starts at or before the byte.
+ */
+m3c_size_t __M3C_ASM_Edit_findFragment(M3C_ASM_FragmentsCache const *fragments, m3c_u8 const *ptr) {
+    m3c_size_t lo = 0;
+    m3c_size_t hi = fragments->len;
+    m3c_size_t mid;
+
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if (fragments->data[mid].bFirst <= ptr)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * \brief Moves the fragment from the old buffer to the new one.
+ *
+ * \param delta change of the offset of the fragment
+ * \param lineDelta change of the line of the fragment
+ */
+void __M3C_ASM_Edit_rebaseFragment(
+    M3C_ASM_Edit const *edit, M3C_ASM_Fragment *fragment, m3c_u32 delta, m3c_u32 lineDelta
+) {
+    m3c_u8 const *oldFirst = edit->document->bFirst;
+    m3c_u8 const *newFirst = edit->relexed.bFirst;
+
+    fragment->bFirst = newFirst + (__M3C_ASM_EDIT_OFFSET(fragment->bFirst, oldFirst) + delta);
+    if (fragment->bLast)
+        fragment->bLast = newFirst + (__M3C_ASM_EDIT_OFFSET(fragment->bLast, oldFirst) + delta);
+    fragment->pos.line += lineDelta;
+}
+
+/**
+ * \brief Splits again the fragments around the edit into \ref M3C_ASM_Edit::fragments "fragments".
+ *
+ * \details The fragment before the edit is split again too: its EOL may merge with the inserted
+ * bytes (e.g. `\r` followed by `\n`). Splitting stops once the new fragment starts at the
+ * (shifted) start of an old one after the edit: a fragment depends only on the bytes from its
+ * start, so the rest of the fragments are the same.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_Edit_splitLines(M3C_ASM_Edit *edit) {
+    M3C_ASM_FragmentsCache const *oldFragments = &edit->document->fragments;
+    m3c_u8 const *oldFirst = edit->document->bFirst;
+    M3C_ASM_LineSplitter splitter;
+    m3c_size_t first;
+    m3c_size_t last;
+    m3c_u32 next;
+    m3c_u32 oldNext;
+
+    first = __M3C_ASM_Edit_findFragment(oldFragments, oldFirst + edit->start);
+    if (first > 0)
+        --first;
+
+    __M3C_ASM_LineSplitter_Init(&splitter, &edit->relexed, edit->relexed.usesPreproc);
+    splitter.ptr = edit->relexed.bFirst +
+                   __M3C_ASM_EDIT_OFFSET(oldFragments->data[first].bFirst, oldFirst);
+    splitter.line = oldFragments->data[first].pos.line;
+
+    last = first;
+    edit->lineDelta = 0;
+    M3C_LOOP {
+        if (M3C_VEC_RESERVE_UNUSED(M3C_ASM_Fragment, &edit->fragments, 1) != M3C_ERROR_OK)
+            return M3C_ERROR_OOM;
+        edit->fragments.len += __M3C_ASM_LineSplitter_Split(
+            &splitter, &edit->fragments.data[edit->fragments.len], 1
+        );
+
+        if (!splitter.ptr) {
+            last = oldFragments->len;
+            break;
+        }
+
+        next = __M3C_ASM_EDIT_OFFSET(splitter.ptr, edit->relexed.bFirst);
+        if (next < edit->newEnd)
+            continue;
+
+        oldNext = next - edit->newEnd + edit->end;
+        while (last < oldFragments->len &&
+               __M3C_ASM_EDIT_OFFSET(oldFragments->data[last].bFirst, oldFirst) < oldNext)
+            ++last;
+        if (last < oldFragments->len &&
+            __M3C_ASM_EDIT_OFFSET(oldFragments->data[last].bFirst, oldFirst) == oldNext) {
+            edit->lineDelta = splitter.line - oldFragments->data[last].pos.line;
+            break;
+        }
+    }
+
+    edit->firstFragment = first;
+    edit->lastFragment = last;
+
+    /* NOTE: tokens may span the cut fragments, so lexing starts at the logical line. The fragments
+     * before the edit are the same in the new document */
+    while (first > 0 && !__M3C_ASM_LEXER_IS_TOKEN_BOUNDARY(
+                            &oldFragments->data[first - 1], &oldFragments->data[first]
+                        ))
+        --first;
+    edit->relexFragment = first;
+
+    return M3C_ERROR_OK;
+}
+
+/**
+ * \brief Replaces the fragments split again and moves the others to the new buffer.
+ *
+ * \warning The fragments must have room for the new ones.
+ */
+void __M3C_ASM_Edit_spliceFragments(M3C_ASM_Edit const *edit) {
+    M3C_ASM_FragmentsCache *fragments = &edit->document->fragments;
+    m3c_size_t first = edit->firstFragment;
+    m3c_size_t last = edit->lastFragment;
+    m3c_size_t newLast = first + edit->fragments.len;
+    m3c_size_t i;
+
+    if (fragments->len > last && newLast != last)
+        m3c_memmove(
+            &fragments->data[newLast], &fragments->data[last],
+            (fragments->len - last) * sizeof(M3C_ASM_Fragment)
+        );
+    m3c_memcpy(
+        &fragments->data[first], edit->fragments.data,
+        edit->fragments.len * sizeof(M3C_ASM_Fragment)
+    );
+    fragments->len = fragments->len - (last - first) + edit->fragments.len;
+
+    for (i = 0; i < first; ++i)
+        __M3C_ASM_Edit_rebaseFragment(edit, &fragments->data[i], 0, 0);
+    for (i = newLast; i < fragments->len; ++i)
+        __M3C_ASM_Edit_rebaseFragment(edit, &fragments->data[i], edit->delta, edit->lineDelta);
+}
+
+/**
+ * \brief Returns the handle of the first token that starts at or after the offset.
+ */
+m3c_size_t __M3C_ASM_Edit_findToken(M3C_ASM_Tokens const *tokens, m3c_u32 offset) {
+    m3c_size_t lo = 0;
+    m3c_size_t hi = tokens->len;
+    m3c_size_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (M3C_ASM_TOKENS_OFFSET(tokens, mid) < offset)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * \brief Returns the index of the first diagnostic of the token with the handle not less than
+ * `hToken`.
+ *
+ * \note Diagnostics are pushed in the order of the tokens, so they are sorted by the handle.
+ */
+m3c_size_t __M3C_ASM_Edit_findDiagnostic(M3C_Diagnostics const *diagnostics, m3c_size_t hToken) {
+    m3c_size_t lo = 0;
+    m3c_size_t hi = diagnostics->vec.len;
+    m3c_size_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (diagnostics->vec.data[mid].data.ASM.hToken < hToken)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/**
+ * \brief Lexes the tokens around the edit into \ref M3C_ASM_Edit::relexed "relexed" tokens.
+ *
+ * \details Lexing stops right after the first \ref term_eol "EOL" token that ends after the edit
+ * where an old EOL token ended: the next tokens are the same as the old ones.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if failed to push token, diagnostic, or lexeme
+ */
+M3C_ERROR __M3C_ASM_Edit_lex(M3C_ASM_Edit *edit, M3C_ASM_PreProc *preproc) {
+    M3C_ASM_Tokens const *oldTokens = &edit->document->tokens;
+    M3C_ASM_Tokens const *tokens = &edit->relexed.tokens;
+    M3C_ASM_Fragment const *fragment;
+    M3C_ASM_Lexer lexer;
+    M3C_ERROR res;
+    m3c_size_t hToken;
+    m3c_size_t last;
+    m3c_u32 offset;
+    m3c_u32 tokEnd;
+    m3c_u32 oldEnd;
+
+    /* NOTE: a document without tokens may be split but not lexed (or lexed by #M3C_ASM_Lexer_Next),
+     * so there are no tokens before the edit to keep */
+    if (oldTokens->len == 0)
+        edit->relexFragment = 0;
+    fragment = &edit->document->fragments.data[edit->relexFragment];
+    offset = __M3C_ASM_EDIT_OFFSET(fragment->bFirst, edit->document->bFirst);
+
+    __M3C_ASM_Lexer_InitCommon(&lexer, preproc, &edit->relexed);
+
+    /* NOTE: the new bytes are split lazily, so only the lexed fragments are split */
+    __M3C_ASM_LineSplitter_Init(&lexer.splitter, &edit->relexed, edit->relexed.usesPreproc);
+    lexer.splitter.ptr = edit->relexed.bFirst + offset;
+    lexer.splitter.line = fragment->pos.line;
+    __M3C_ASM_Lexer_SplitMore(&lexer);
+    lexer.ptr = lexer.fragment->bFirst;
+
+    edit->firstToken = __M3C_ASM_Edit_findToken(oldTokens, offset);
+
+    lexer.tokens = &edit->relexed.tokens;
+    lexer.batch = M3C_NULL;
+    lexer.nTokens = edit->firstToken;
+
+    edit->isLexedToEOF = m3c_false;
+    hToken = 0;
+    last = edit->firstToken;
+    M3C_LOOP {
+        res = __M3C_ASM_Lexer_NextToken(&lexer);
+        if (res == M3C_ERROR_EOF) {
+            edit->lastToken = oldTokens->len;
+            edit->isLexedToEOF = m3c_true;
+            return M3C_ERROR_OK;
+        } else if (res != M3C_ERROR_OK)
+            return res;
+
+        for (; hToken < tokens->len; ++hToken) {
+            if (M3C_ASM_TOKENS_KIND(tokens, hToken) != M3C_ASM_TOKEN_KIND_EOL)
+                continue;
+
+            tokEnd = M3C_ASM_TOKENS_OFFSET(tokens, hToken) + M3C_ASM_TOKENS_LEN(tokens, hToken);
+            if (tokEnd < edit->newEnd)
+                continue;
+
+            oldEnd = tokEnd - edit->newEnd + edit->end;
+            while (last < oldTokens->len && M3C_ASM_TOKENS_OFFSET(oldTokens, last) < oldEnd)
+                ++last;
+            if (last > 0 && M3C_ASM_TOKENS_KIND(oldTokens, last - 1) == M3C_ASM_TOKEN_KIND_EOL &&
+                M3C_ASM_TOKENS_OFFSET(oldTokens, last - 1) +
+                        M3C_ASM_TOKENS_LEN(oldTokens, last - 1) ==
+                    oldEnd) {
+                edit->lastToken = last;
+                return M3C_ERROR_OK;
+            }
+        }
+    }
+}
+
+/**
+ * \brief Replaces the diagnostics of the lexed again tokens and shifts the next ones.
+ *
+ * \warning The diagnostics must have room for the new ones.
+ */
+void __M3C_ASM_Edit_spliceDiagnostics(M3C_ASM_Edit const *edit) {
+    M3C_Diagnostics *diagnostics = &edit->document->diagnostics;
+    M3C_Diagnostics const *src = &edit->relexed.diagnostics;
+    m3c_u32 tokenDelta = (m3c_u32)(edit->relexed.tokens.len - (edit->lastToken - edit->firstToken));
+    m3c_size_t first;
+    m3c_size_t last;
+    m3c_size_t i;
+
+    first = __M3C_ASM_Edit_findDiagnostic(diagnostics, edit->firstToken);
+    /* NOTE: if the tokens are lexed again until EOF, so are all diagnostics after them */
+    last = edit->isLexedToEOF ? diagnostics->vec.len
+                              : __M3C_ASM_Edit_findDiagnostic(diagnostics, edit->lastToken);
+
+    for (i = first; i < last; ++i) {
+        if (diagnostics->vec.data[i].severity == M3C_SEVERITY_WARNING)
+            --diagnostics->warnings;
+        else if (diagnostics->vec.data[i].severity >= M3C_SEVERITY_ERROR)
+            --diagnostics->errors;
+    }
+    diagnostics->warnings += src->warnings;
+    diagnostics->errors += src->errors;
+
+    /* NOTE: an empty vector may be `NULL` */
+    if (diagnostics->vec.len > last && last - first != src->vec.len)
+        m3c_memmove(
+            &diagnostics->vec.data[first + src->vec.len], &diagnostics->vec.data[last],
+            (diagnostics->vec.len - last) * sizeof(M3C_Diagnostic)
+        );
+    if (src->vec.len)
+        m3c_memcpy(
+            &diagnostics->vec.data[first], src->vec.data, src->vec.len * sizeof(M3C_Diagnostic)
+        );
+    diagnostics->vec.len = diagnostics->vec.len - (last - first) + src->vec.len;
+
+    for (i = first + src->vec.len; i < diagnostics->vec.len; ++i) {
+        diagnostics->vec.data[i].data.ASM.hToken += tokenDelta;
+        diagnostics->vec.data[i].data.ASM.start += edit->delta;
+        diagnostics->vec.data[i].data.ASM.end += edit->delta;
+    }
+}
+
+/**
+ * \brief Checks that the valid UTF-8 bytes are all ASCII.
+ */
+m3c_bool __M3C_ASM_Edit_isASCII(m3c_u8 const *ptr, m3c_size_t len) {
+    m3c_bool isASCII;
+
+    if (len == 0)
+        return m3c_true;
+
+    return M3C_UTF8ValidateBuffer(ptr, ptr + len - 1, &isASCII) == M3C_UTF8_OK && isASCII;
+}
+
+/**
+ * \brief Computes the encoding of the edited document.
+ *
+ * \details The document stays valid if the inserted bytes are valid and the edit doesn't cut any
+ * UTF-8 sequence. Otherwise the encoding is unknown. A valid document is ASCII if all its bytes are
+ * ASCII, just as after \ref term_phase_ls "Line Splitting Phase".
+ */
+M3C_ASM_DocumentEncoding __M3C_ASM_Edit_encoding(
+    M3C_ASM_Edit const *edit, m3c_u8 const *text, m3c_size_t textLen
+) {
+    M3C_ASM_Document const *document = edit->document;
+    m3c_u8 const *oldFirst = document->bFirst;
+    m3c_size_t oldLen = document->bLast ? (m3c_size_t)(document->bLast - oldFirst) + 1 : 0;
+    m3c_bool isASCII = m3c_true;
+
+    if (document->encoding != M3C_ASM_DOCUMENT_ENCODING_UTF8 &&
+        document->encoding != M3C_ASM_DOCUMENT_ENCODING_ASCII)
+        return M3C_ASM_DOCUMENT_ENCODING_UNKNOWN;
+
+    if ((edit->start < oldLen && __M3C_ASM_EDIT_IS_CONTINUATION(oldFirst[edit->start])) ||
+        (edit->end < oldLen && __M3C_ASM_EDIT_IS_CONTINUATION(oldFirst[edit->end])))
+        return M3C_ASM_DOCUMENT_ENCODING_UNKNOWN;
+
+    if (textLen && M3C_UTF8ValidateBuffer(text, text + textLen - 1, &isASCII) != M3C_UTF8_OK)
+        return M3C_ASM_DOCUMENT_ENCODING_UNKNOWN;
+
+    if (!isASCII)
+        return M3C_ASM_DOCUMENT_ENCODING_UTF8;
+    if (document->encoding == M3C_ASM_DOCUMENT_ENCODING_ASCII)
+        return M3C_ASM_DOCUMENT_ENCODING_ASCII;
+
+    /* NOTE: the kept bytes (as many as the document) are checked only if the replaced ones may be
+     * the last non-ASCII bytes */
+    if (__M3C_ASM_Edit_isASCII(oldFirst + edit->start, edit->end - edit->start))
+        return M3C_ASM_DOCUMENT_ENCODING_UTF8;
+
+    return __M3C_ASM_Edit_isASCII(oldFirst, edit->start) &&
+                   __M3C_ASM_Edit_isASCII(oldFirst + edit->end, oldLen - edit->end)
+               ? M3C_ASM_DOCUMENT_ENCODING_ASCII
+               : M3C_ASM_DOCUMENT_ENCODING_UTF8;
+}
+
+/**
+ * \brief Splits and lexes the edited document into the edit state and applies it to the document.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory. The document is intact
+ */
+M3C_ERROR __M3C_ASM_Edit_apply(M3C_ASM_Edit *edit, M3C_ASM_PreProc *preproc) {
+    M3C_ASM_Document *document = edit->document;
+    M3C_ASM_Fragment *fragments;
+    m3c_size_t fragmentsLen;
+    M3C_ERROR res;
+
+    res = __M3C_ASM_Edit_splitLines(edit);
+    if (res != M3C_ERROR_OK)
+        return res;
+
+    res = __M3C_ASM_Edit_lex(edit, preproc);
+    if (res != M3C_ERROR_OK)
+        return res;
+
+    /* NOTE: all memory is allocated before the document is changed */
+    if (M3C_VEC_RESERVE_UNUSED(
+            M3C_Diagnostic, &document->diagnostics.vec, edit->relexed.diagnostics.vec.len
+        ) != M3C_ERROR_OK ||
+        M3C_VEC_RESERVE_UNUSED(m3c_u32, &document->stringRefs, edit->relexed.stringRefs.len) !=
+            M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+
+    fragmentsLen = document->fragments.len - (edit->lastFragment - edit->firstFragment) +
+                   edit->fragments.len;
+    if (fragmentsLen > document->fragments.len) {
+        fragments = (M3C_ASM_Fragment *)m3c_realloc(
+            document->fragments.data, fragmentsLen * sizeof(M3C_ASM_Fragment)
+        );
+        if (!fragments)
+            return M3C_ERROR_OOM;
+        document->fragments.data = fragments;
+    }
+
+    res = __M3C_ASM_Tokens_Splice(
+        &document->tokens, edit->firstToken, edit->lastToken, &edit->relexed.tokens, edit->delta
+    );
+    if (res != M3C_ERROR_OK)
+        return res;
+
+    __M3C_ASM_Edit_spliceDiagnostics(edit);
+    __M3C_ASM_Edit_spliceFragments(edit);
+
+    return M3C_ERROR_OK;
+}
+
+M3C_ERROR M3C_ASM_Document_ApplyEdit(
+    M3C_ASM_PreProc *preproc, M3C_ASM_hDocument hDocument, M3C_ASM_Range range, m3c_u8 const *text,
+    m3c_size_t textLen
+) {
+    M3C_ASM_Document *document;
+    M3C_ASM_Edit edit;
+    M3C_FileMapping mapping;
+    m3c_u8 *buf;
+    m3c_size_t oldLen;
+    m3c_size_t keptLen;
+    m3c_size_t newLen;
+    M3C_ERROR res = M3C_ERROR_OK;
+
+    if (hDocument >= preproc->documents.len)
+        return M3C_ERROR_BAD_HANDLE;
+
+    document = &preproc->documents.data[hDocument];
+
+    oldLen = document->bLast ? (m3c_size_t)(document->bLast - document->bFirst) + 1 : 0;
+    if (oldLen > M3C_ASM_DOCUMENT_MAX_BLEN || range.start > range.end || range.end > oldLen)
+        return M3C_ERROR_OOB;
+
+    keptLen = oldLen - (range.end - range.start);
+    if (textLen > M3C_ASM_DOCUMENT_MAX_BLEN - keptLen)
+        return M3C_ERROR_OOB;
+    newLen = keptLen + textLen;
+
+    /* NOTE: the buffer of an empty document can't be `NULL` either */
+    buf = (m3c_u8 *)m3c_malloc(newLen ? newLen : 1);
+    if (!buf)
+        return M3C_ERROR_OOM;
+
+    m3c_memcpy(buf, document->bFirst, range.start);
+    if (textLen)
+        m3c_memcpy(buf + range.start, text, textLen);
+    m3c_memcpy(buf + range.start + textLen, document->bFirst + range.end, oldLen - range.end);
+
+    edit.document = document;
+    edit.start = range.start;
+    edit.end = range.end;
+    edit.newEnd = (m3c_u32)(range.start + textLen);
+    edit.delta = edit.newEnd - edit.end;
+
+    M3C_ASM_Document_Init(&edit.relexed, buf, newLen);
+    edit.relexed.encoding = __M3C_ASM_Edit_encoding(&edit, text, textLen);
+    edit.relexed.usesPreproc = document->usesPreproc;
+    M3C_VEC_INIT(&edit.fragments);
+
+    /* NOTE: only the strings referencing the replaced bytes are copied. Copying them changes
+     * nothing visible, so it's done even if the edit fails */
+    res = __M3C_ASM_StringPool_Detach(
+        &preproc->stringPool, &document->stringRefs, document->bFirst + range.start,
+        document->bFirst + range.end
+    );
+    if (res == M3C_ERROR_OK && document->fragments.len)
+        res = __M3C_ASM_Edit_apply(&edit, preproc);
+    else if (res == M3C_ERROR_OK) {
+        /* NOTE: the offsets of the diagnostics pushed by #M3C_ASM_Lexer_Next are stale now */
+        document->diagnostics.vec.len = 0;
+        document->diagnostics.warnings = 0;
+        document->diagnostics.errors = 0;
+    }
+
+    __M3C_ASM_Tokens_Deinit(&edit.relexed.tokens);
+    __M3C_Diagnostics_Deinit(&edit.relexed.diagnostics);
+    if (edit.fragments.data)
+        M3C_VEC_DEINIT(&edit.fragments);
+
+    if (res != M3C_ERROR_OK) {
+        /* NOTE: lexed again symbols may reference the new buffer. If they can't be detached, the
+         * buffer is leaked instead of freed */
+        if (__M3C_ASM_StringPool_Detach(
+                &preproc->stringPool, &edit.relexed.stringRefs, buf, buf + newLen
+            ) == M3C_ERROR_OK)
+            m3c_free(buf);
+        M3C_VEC_DEINIT(&edit.relexed.stringRefs);
+        return res;
+    }
+
+    /* NOTE: the other strings reference the kept bytes, so they are moved to the copies of them.
+     * The strings lexed again already reference the new buffer (there is room for them) */
+    __M3C_ASM_StringPool_Move(
+        &preproc->stringPool, &document->stringRefs, document->bFirst,
+        document->bFirst + range.start, buf
+    );
+    __M3C_ASM_StringPool_Move(
+        &preproc->stringPool, &document->stringRefs, document->bFirst + range.end,
+        document->bFirst + oldLen, buf + edit.newEnd
+    );
+    if (edit.relexed.stringRefs.len) {
+        m3c_memcpy(
+            &document->stringRefs.data[document->stringRefs.len], edit.relexed.stringRefs.data,
+            edit.relexed.stringRefs.len * sizeof(m3c_u32)
+        );
+        document->stringRefs.len += edit.relexed.stringRefs.len;
+    }
+    M3C_VEC_DEINIT(&edit.relexed.stringRefs);
+
+    if (document->buf == M3C_ASM_DOCUMENT_BUF_MAPPED) {
+        mapping.ptr = document->bFirst;
+        mapping.len = oldLen;
+
+        M3C_File_Unmap(&mapping);
+    } else if (document->buf == M3C_ASM_DOCUMENT_BUF_ALLOCATED)
+        m3c_free((void *)document->bFirst);
+
+    document->bFirst = edit.relexed.bFirst;
+    document->bLast = edit.relexed.bLast;
+    document->buf = M3C_ASM_DOCUMENT_BUF_ALLOCATED;
+    document->encoding = edit.relexed.encoding;
+
+    return M3C_ERROR_OK;
+}
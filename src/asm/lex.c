@@ -3,17 +3,12 @@
 #include <m3c/common/macros.h>
 #include <m3c/common/utf8.h>
 #include <m3c/rt/alloc.h>
+#include <m3c/rt/mem.h>
+#include <m3c/rt/scan.h>
 #include <m3c/asm/diagnostics_info.h>
+#include <m3c/asm/lexer.h>
 #include <m3c/asm/preproc.h>
-
-#define __ADVANCE_ONLY_PTR lexer->ptr += cpLen
-#define __ADVANCE_ONLY_PTR2 lexer->ptr2 += cpLen
-
-#define __ADVANCE_ONLY_POS ++lexer->pos.character
-#define __ADVANCE_ONLY_POS2 ++lexer->pos2.character
-#define __ADVANCE_ONLY_POS_NL                                                                      \
-    ++lexer->pos.line;                                                                             \
-    lexer->pos.character = 0
+#include <m3c/asm/tokens.h>
 
 #define __VAR_DECL_WITHOUT_N                                                                       \
     M3C_ERROR status;                                                                              \
@@ -28,76 +23,116 @@
  * \brief Reads the character pointed to by the lexer. If there are no characters left in the
  * current fragment, it will move to the next fragment and try to read again.
  *
+ * \details An ASCII byte inside the current fragment is read inline, everything else goes to
+ * #__M3C_ASM_Lexer_peek.
+ *
  * \warning Requires variables to be declared with the #VAR_DECL macro.
  *
  * \see #__M3C_ASM_Lexer_peek
  */
-#define PEEK status = __M3C_ASM_Lexer_peek(lexer, &cp, &cpLen)
+#define PEEK                                                                                       \
+    status = lexer->ptr <= lexer->fragment->bLast && *lexer->ptr < 0x80                            \
+                 ? (cp = *lexer->ptr, cpLen = 1, M3C_ERROR_OK)                                     \
+                 : __M3C_ASM_Lexer_peek(lexer, &cp, &cpLen)
 
 /**
- * @brief As \ref PEEK "PEEK" but is used to reread document using `ptr2`, `pos2`, `fragment2`.
+ * \brief Moves the lexer forward.
+ *
+ * \warning Requires macro #PEEK to be called before it.
  */
-#define PEEK2                                                                                      \
-    status = __M3C_ASM_Lexer_peek2(                                                                \
-        &lexer->ptr2, &lexer->pos2, &lexer->fragment2, lexer->fragmentLast, &cp, &cpLen            \
-    )
+#define ADVANCE lexer->ptr += cpLen
 
 /**
- * \brief Moves the lexer forward, assuming the lexer doesn't point to a newline character.
+ * \brief Fast path: moves the lexer forward over the longest run of bytes in the character classes
+ * `MASK` inside the current fragment.
  *
- * \warning Requires macro #PEEK to be called before it.
+ * \details Unlike #PEEK it doesn't decode code points and doesn't check the fragment boundary per
+ * code point. It stops at the end of the fragment or at the first byte that isn't in `MASK`
+ * (`MASK` must not contain #M3C_ASM_CHAR_CLASS_EOL). So the slow path (#PEEK) takes over there.
  */
-#define ADVANCE                                                                                    \
-    __ADVANCE_ONLY_PTR;                                                                            \
-    __ADVANCE_ONLY_POS
+#define SKIP_ASCII_WHILE(MASK)                                                                     \
+    do {                                                                                           \
+        m3c_u8 const *_ptr = lexer->ptr;                                                           \
+        m3c_u8 const *_bLast = lexer->fragment->bLast;                                             \
+                                                                                                   \
+        /* NOTE: `bLast` is `NULL` for empty fragments */                                          \
+        if (_bLast) {                                                                              \
+            while (_ptr <= _bLast && M3C_ASM_ByteIs(*_ptr, MASK))                                  \
+                ++_ptr;                                                                            \
+        }                                                                                          \
+                                                                                                   \
+        lexer->ptr = _ptr;                                                                         \
+    } while (0)
+
 /**
- * \brief As \ref ADVANCE "ADVANCE" but is used to reread document using `ptr2`, `pos2`,
- * `fragment2`.
- *
- * \warning Requires macro #PEEK2 to be called before it.
+ * \brief Maximum number of bytes #SKIP_ASCII_SCAN checks in place before calling the scanning
+ * function.
  */
-#define ADVANCE2                                                                                   \
-    __ADVANCE_ONLY_PTR2;                                                                           \
-    __ADVANCE_ONLY_POS2
+#define SKIP_ASCII_SCAN_INLINE 8
+
 /**
- * \brief Moves the lexer forward, assuming the lexer points to a newline character.
+ * \brief As \ref SKIP_ASCII_WHILE "SKIP_ASCII_WHILE" but long runs are skipped by `SCAN` (one of
+ * the vectorized `M3C_Scan_*` functions that skips the same bytes as `MASK`).
  *
- * \warning Requires macro #PEEK to be called before it.
+ * \details The first #SKIP_ASCII_SCAN_INLINE bytes are checked in place, so short runs (e.g. a
+ * space between operands) don't pay for the call.
  */
-#define ADVANCE_NL                                                                                 \
-    __ADVANCE_ONLY_PTR;                                                                            \
-    __ADVANCE_ONLY_POS_NL
+#define SKIP_ASCII_SCAN(MASK, SCAN)                                                                \
+    do {                                                                                           \
+        m3c_u8 const *_ptr = lexer->ptr;                                                           \
+        m3c_u8 const *_bLast = lexer->fragment->bLast;                                             \
+        int _n = 0;                                                                                \
+                                                                                                   \
+        /* NOTE: `bLast` is `NULL` for empty fragments */                                          \
+        if (_bLast) {                                                                              \
+            while (_ptr <= _bLast && M3C_ASM_ByteIs(*_ptr, MASK)) {                                \
+                ++_ptr;                                                                            \
+                if (++_n == SKIP_ASCII_SCAN_INLINE) {                                              \
+                    _ptr = SCAN(_ptr, _bLast);                                                     \
+                    break;                                                                         \
+                }                                                                                  \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        lexer->ptr = _ptr;                                                                         \
+    } while (0)
 
 /**
- * \brief Sets the ptr and start position of the token.
+ * \brief Offset of the byte pointed to by the lexer from the start of the document.
+ */
+#define OFFSET ((m3c_u32)(lexer->ptr - lexer->bFirst))
+
+/**
+ * \brief Sets the offset of the token.
  *
  * \details The lexer must point to the first character of the token.
  */
 #define TOK_START                                                                                  \
-    lexer->token.start = lexer->pos;                                                               \
-    lexer->token.lexeme.hStr = 0;                                                                  \
-    /* save info for token rereading */                                                            \
-    lexer->ptr2 = lexer->ptr;                                                                      \
-    lexer->pos2 = lexer->pos;                                                                      \
-    lexer->fragment2 = lexer->fragment
+    lexer->token.offset = OFFSET;                                                                  \
+    lexer->token.lexeme.hStr = 0
 /**
- * \brief Sets the end position of the token.
+ * \brief Sets the length of the token.
  *
  * \details The lexer must point to the next character after the token.
  */
-#define TOK_END lexer->token.end = lexer->pos
+#define TOK_END lexer->token.len = OFFSET - lexer->token.offset
 /**
  * \brief Sets the kind of the token.
  */
 #define TOK_KIND(KIND) lexer->token.kind = KIND
 /**
- * \brief Pushes the token.
+ * \brief Pushes the token to the tokens of the document or writes it to the batch.
+ *
+ * \note There is always room in the batch, as each token is lexed only if there is.
  *
  * \return
  * + M3C_ERROR_OK
  * + M3C_ERROR_OOM - if failed to realloc
  */
-#define TOK_PUSH M3C_VEC_PUSH(M3C_ASM_Token, lexer->tokens, &lexer->token)
+#define TOK_PUSH                                                                                   \
+    (++lexer->nTokens,                                                                             \
+     lexer->batch ? (lexer->batch[lexer->batchLen++] = lexer->token, M3C_ERROR_OK)                 \
+                  : __M3C_ASM_Tokens_Push(lexer->tokens, &lexer->token))
 
 /**
  * \brief Push string to the preproc's stringPool.
@@ -106,197 +141,378 @@
  * + M3C_ERROR_OK
  * + M3C_ERROR_OOM - if failed to realloc
  */
-#define STR_PUSH(str) M3C_VEC_PUSH(M3C_ASM_CachedString, lexer->stringPool, (str))
+#define STR_PUSH(str) M3C_VEC_PUSH(M3C_ASM_CachedString, &lexer->stringPool->strings, (str))
 
 /**
- * \brief Sets the diagnostic start position from the current lexer position.
+ * \brief Sets the diagnostic start from the current lexer offset.
  *
  * \details The lexer must point to the first character of the diagnostic.
  */
 #define DIAG_START_FROM_LEXER(diag)                                                                \
-    (diag)->data.ASM.start = lexer->pos;                                                           \
-    (diag)->data.ASM.hToken = lexer->tokens->len
+    (diag)->data.ASM.start = OFFSET;                                                               \
+    (diag)->data.ASM.hToken = lexer->nTokens
 /**
- * \brief Sets the diagnostic start position from the token start position.
+ * \brief Sets the diagnostic start from the token offset.
  */
 #define DIAG_START_FROM_TOKEN(diag)                                                                \
-    (diag)->data.ASM.start = lexer->token.start;                                                   \
-    (diag)->data.ASM.hToken = lexer->tokens->len
+    (diag)->data.ASM.start = lexer->token.offset;                                                  \
+    (diag)->data.ASM.hToken = lexer->nTokens
 /**
- * \brief Sets the end position of the diagnostic.
+ * \brief Sets the end of the diagnostic.
  *
  * \details The lexer must point to the next character after the diagnostic.
  */
-#define DIAG_END(diag) (diag)->data.ASM.end = lexer->pos
-
-typedef struct __tagM3C_ASM_ASCIIRange {
-    m3c_u8 lo;
-    m3c_u8 hi;
-} M3C_ASM_ASCIIRange;
-
-const M3C_ASM_ASCIIRange __underscore_digits_letters[8] = {
-  /* the order is important */
-    {'_', '_'},
-    {'0', '1'},
-    {'2', '7'},
-    {'8', '9'},
-    {'A', 'F'},
-    {'a', 'f'},
-    {'G', 'Z'},
-    {'g', 'z'}
-};
+#define DIAG_END(diag) (diag)->data.ASM.end = OFFSET
 
 /**
- * \brief Digits (binary, octal, decimal, hexadecimal).
- *
- * \details To use see #DIGITS_LEN_BIN, #DIGITS_LEN_OCT, #DIGITS_LEN_DEC, #DIGITS_LEN_HEX.
+ * \brief Space or `\t`.
+ */
+#define M3C_ASM_CHAR_CLASS_BLANK 0x0001
+/**
+ * \brief `\n` or `\r`.
  */
-#define DIGITS &__underscore_digits_letters[1]
+#define M3C_ASM_CHAR_CLASS_EOL 0x0002
 /**
  * \brief `[01]`.
- *
- * \details See #DIGITS.
  */
-#define DIGITS_LEN_BIN 1
+#define M3C_ASM_CHAR_CLASS_DIGIT_BIN 0x0004
 /**
  * \brief `[0-7]`.
- *
- * \details See #DIGITS.
  */
-#define DIGITS_LEN_OCT 2
+#define M3C_ASM_CHAR_CLASS_DIGIT_OCT 0x0008
 /**
  * \brief `[0-9]`.
- *
- * \details See #DIGITS.
  */
-#define DIGITS_LEN_DEC 3
+#define M3C_ASM_CHAR_CLASS_DIGIT_DEC 0x0010
 /**
  * \brief `[0-9A-Fa-f]`.
- *
- * \details See #DIGITS.
  */
-#define DIGITS_LEN_HEX 5
-
+#define M3C_ASM_CHAR_CLASS_DIGIT_HEX 0x0020
 /**
- * \brief Underscore (`_`) and digits (binary, octal, decimal, hexadecimal).
- *
- * \details To use see #UNDERSCORE_DIGITS_LEN_BIN, #UNDERSCORE_DIGITS_LEN_OCT,
- * #UNDERSCORE_DIGITS_LEN_DEC, #UNDERSCORE_DIGITS_LEN_HEX.
+ * \brief `[A-Za-z]`.
  */
-#define UNDERSCORE_DIGITS &__underscore_digits_letters[0]
+#define M3C_ASM_CHAR_CLASS_LETTER 0x0040
 /**
- * \brief `[_0-1]`.
- *
- * \details See #UNDERSCORE_DIGITS.
+ * \brief `_`.
  */
-#define UNDERSCORE_DIGITS_LEN_BIN 2
+#define M3C_ASM_CHAR_CLASS_UNDERSCORE 0x0080
 /**
- * \brief `[_0-7]`.
- *
- * \details See #UNDERSCORE_DIGITS.
+ * \brief The first character of a punctuator, comment or string literal (it ends an unrecognized
+ * token).
  */
-#define UNDERSCORE_DIGITS_LEN_OCT 3
+#define M3C_ASM_CHAR_CLASS_PUNCT 0x0100
 /**
- * \brief `[_0-9]`.
- *
- * \details See #UNDERSCORE_DIGITS.
+ * \brief Any ASCII character except EOL (a comment body).
  */
-#define UNDERSCORE_DIGITS_LEN_DEC 4
+#define M3C_ASM_CHAR_CLASS_TEXT 0x0200
 /**
- * \brief `[_0-9A-Fa-f]`.
- *
- * \details See #UNDERSCORE_DIGITS.
+ * \brief Any ASCII character except EOL, `"` and `\` (a string literal body that needs no special
+ * handling).
  */
-#define UNDERSCORE_DIGITS_LEN_HEX 6
+#define M3C_ASM_CHAR_CLASS_STRING 0x0400
 
 /**
- * \brief Digits and letters (lower and upper case).
- *
- * \details To use see #DIGITS_LETTERS_LEN.
+ * \brief `[_A-Za-z]`.
  */
-#define DIGITS_LETTERS &__underscore_digits_letters[1]
+#define M3C_ASM_CHAR_CLASS_SYMBOL_START (M3C_ASM_CHAR_CLASS_LETTER | M3C_ASM_CHAR_CLASS_UNDERSCORE)
 /**
- * \brief `[0-9A-Za-z]`.
- *
- * \details See #DIGITS_LETTERS.
+ * \brief `[_0-9A-Za-z]`.
  */
-#define DIGITS_LETTERS_LEN 7
-
+#define M3C_ASM_CHAR_CLASS_SYMBOL_BODY                                                             \
+    (M3C_ASM_CHAR_CLASS_SYMBOL_START | M3C_ASM_CHAR_CLASS_DIGIT_DEC)
 /**
- * \brief Underscore (`_`), digits and letters (lower and upper case).
- *
- * \details To use see #UNDERSCORE_DIGITS_LETTERS_LEN.
+ * \brief Characters that end an unrecognized token (the first character of any other token).
  */
-#define UNDERSCORE_DIGITS_LETTERS &__underscore_digits_letters[0]
+#define M3C_ASM_CHAR_CLASS_TOKEN_BOUNDARY                                                          \
+    (M3C_ASM_CHAR_CLASS_BLANK | M3C_ASM_CHAR_CLASS_EOL | M3C_ASM_CHAR_CLASS_SYMBOL_BODY |          \
+     M3C_ASM_CHAR_CLASS_PUNCT)
+
+#define __ 0
+#define TX (M3C_ASM_CHAR_CLASS_TEXT | M3C_ASM_CHAR_CLASS_STRING)
+#define BL (M3C_ASM_CHAR_CLASS_BLANK | TX)
+#define EL M3C_ASM_CHAR_CLASS_EOL
+#define PU (M3C_ASM_CHAR_CLASS_PUNCT | TX)
+#define QU (M3C_ASM_CHAR_CLASS_PUNCT | M3C_ASM_CHAR_CLASS_TEXT)
+#define BS M3C_ASM_CHAR_CLASS_TEXT
+#define DA (M3C_ASM_CHAR_CLASS_DIGIT_DEC | M3C_ASM_CHAR_CLASS_DIGIT_HEX | TX)
+#define D8 (M3C_ASM_CHAR_CLASS_DIGIT_OCT | DA)
+#define D2 (M3C_ASM_CHAR_CLASS_DIGIT_BIN | D8)
+#define LE (M3C_ASM_CHAR_CLASS_LETTER | TX)
+#define HX (M3C_ASM_CHAR_CLASS_DIGIT_HEX | LE)
+#define US (M3C_ASM_CHAR_CLASS_UNDERSCORE | TX)
+
 /**
- * \brief `[_0-9A-Za-z]`.
+ * \brief Character classes (`M3C_ASM_CHAR_CLASS_*` bitmask) of each byte.
  *
- * \details See #UNDERSCORE_DIGITS_LETTERS.
+ * \details Non-ASCII bytes have no classes, so they never match.
  */
-#define UNDERSCORE_DIGITS_LETTERS_LEN 8
-
-#define M3C_InRange_LETTER(cp) (M3C_InRange((cp), 'A', 'Z') || M3C_InRange((cp), 'a', 'z'))
-
-#define M3C_InRange_DIGIT_HEX(cp)                                                                  \
-    (M3C_InRange(cp, '0', '9') || M3C_InRange(cp, 'A', 'F') || M3C_InRange(cp, 'a', 'f'))
+m3c_u16 const __M3C_ASM_CHAR_CLASSES[256] = {
+    /* 0x00 */ TX, TX, TX, TX, TX, TX, TX, TX, TX, BL, EL, TX, TX, EL, TX, TX,
+    /* 0x10 */ TX, TX, TX, TX, TX, TX, TX, TX, TX, TX, TX, TX, TX, TX, TX, TX,
+    /* 0x20 */ BL, PU, QU, TX, TX, PU, PU, TX, PU, PU, PU, PU, PU, PU, TX, PU,
+    /* 0x30 */ D2, D2, D8, D8, D8, D8, D8, D8, DA, DA, PU, PU, PU, PU, PU, PU,
+    /* 0x40 */ TX, HX, HX, HX, HX, HX, HX, LE, LE, LE, LE, LE, LE, LE, LE, LE,
+    /* 0x50 */ LE, LE, LE, LE, LE, LE, LE, LE, LE, LE, LE, TX, BS, TX, PU, US,
+    /* 0x60 */ TX, HX, HX, HX, HX, HX, HX, LE, LE, LE, LE, LE, LE, LE, LE, LE,
+    /* 0x70 */ LE, LE, LE, LE, LE, LE, LE, LE, LE, LE, LE, TX, PU, TX, PU, TX,
+    /* 0x80 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0x90 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xA0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xB0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xC0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xD0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xE0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xF0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __
+};
 
-#define M3C_InRange_PRINTABLE(cp) (M3C_InRange(cp, ' ', '~'))
+#undef __
+#undef TX
+#undef BL
+#undef EL
+#undef PU
+#undef QU
+#undef BS
+#undef DA
+#undef D8
+#undef D2
+#undef LE
+#undef HX
+#undef US
 
-#define M3C_GetHexVal(cp) M3C_InRange(cp, '0', '9') ? cp - '0' : (cp & 0x1F) + 9
+/**
+ * \brief Checks if the byte is in any of the character classes of the `mask`.
+ */
+#define M3C_ASM_ByteIs(b, mask) (__M3C_ASM_CHAR_CLASSES[(b)] & (mask))
 
-#define M3C_BIN_PREFIX(cp) ((cp) == 'b' || (cp) == 'B' || (cp) == 'y' || (cp) == 'Y')
-#define M3C_OCT_PREFIX(cp) ((cp) == 'o' || (cp) == 'O' || (cp) == 'q' || (cp) == 'Q')
-#define M3C_DEC_PREFIX(cp) ((cp) == 'd' || (cp) == 'D')
-#define M3C_HEX_PREFIX(cp) ((cp) == 'x' || (cp) == 'X' || (cp) == 'h' || (cp) == 'H')
+/**
+ * \brief Checks if the code point is in any of the character classes of the `mask`.
+ */
+#define M3C_ASM_CharIs(cp, mask) ((cp) < 0x80 && M3C_ASM_ByteIs(cp, mask))
 
-typedef struct __tagM3C_ASM_Lexer {
-    m3c_u8 const *ptr;
-    M3C_ASM_Position pos;
-    m3c_u8 const *bLast;
-    M3C_ASM_Fragment *fragment;
-    M3C_ASM_Fragment *fragmentLast;
+/**
+ * \brief What #__M3C_ASM_Lexer_NextToken does with the first byte of the token.
+ */
+typedef enum __tagM3C_ASM_LexAction {
+    /**
+     * \brief Unrecognized token (also non-ASCII bytes).
+     */
+    M3C_ASM_LEX_ACTION_UNRECOGNIZED = 0,
+    /**
+     * \brief `\n`.
+     */
+    M3C_ASM_LEX_ACTION_LF,
+    /**
+     * \brief `\r`.
+     */
+    M3C_ASM_LEX_ACTION_CR,
+    /**
+     * \brief `!` or `!=`.
+     */
+    M3C_ASM_LEX_ACTION_EXCLAIM,
+    /**
+     * \brief String literal.
+     */
+    M3C_ASM_LEX_ACTION_STRING,
+    /**
+     * \brief `%`.
+     */
+    M3C_ASM_LEX_ACTION_PERCENT,
+    /**
+     * \brief `&` or `&&`.
+     */
+    M3C_ASM_LEX_ACTION_AMP,
+    /**
+     * \brief `(`.
+     */
+    M3C_ASM_LEX_ACTION_L_PAREN,
+    /**
+     * \brief `)`.
+     */
+    M3C_ASM_LEX_ACTION_R_PAREN,
+    /**
+     * \brief `*`.
+     */
+    M3C_ASM_LEX_ACTION_STAR,
+    /**
+     * \brief `+`.
+     */
+    M3C_ASM_LEX_ACTION_PLUS,
+    /**
+     * \brief `,`.
+     */
+    M3C_ASM_LEX_ACTION_COMMA,
+    /**
+     * \brief `-`.
+     */
+    M3C_ASM_LEX_ACTION_MINUS,
+    /**
+     * \brief `/`.
+     */
+    M3C_ASM_LEX_ACTION_SLASH,
+    /**
+     * \brief Number literal starting with `0`.
+     */
+    M3C_ASM_LEX_ACTION_ZERO,
+    /**
+     * \brief Number literal starting with `[1-9]`.
+     */
+    M3C_ASM_LEX_ACTION_DIGIT,
+    /**
+     * \brief `:`.
+     */
+    M3C_ASM_LEX_ACTION_COLON,
+    /**
+     * \brief Comment.
+     */
+    M3C_ASM_LEX_ACTION_COMMENT,
+    /**
+     * \brief `<`, `<<` or `<=`.
+     */
+    M3C_ASM_LEX_ACTION_LESS,
+    /**
+     * \brief `==`.
+     */
+    M3C_ASM_LEX_ACTION_EQUAL,
     /**
-     * \brief Actual token.
+     * \brief `>`, `>>` or `>=`.
      */
-    M3C_ASM_Token token;
-    M3C_ASM_Tokens *tokens;
-    M3C_Diagnostics *diagnostics;
+    M3C_ASM_LEX_ACTION_GREATER,
     /**
-     * \brief Pointer to the first byte of the actual token.
+     * \brief `?`.
      */
-    m3c_u8 const *ptr2;
+    M3C_ASM_LEX_ACTION_QUESTION,
     /**
-     * \brief Position of the first character of the actual token.
+     * \brief Symbol.
      */
-    M3C_ASM_Position pos2;
+    M3C_ASM_LEX_ACTION_SYMBOL,
     /**
-     * \brief Fragment, where the actual token has started.
+     * \brief `^`.
      */
-    M3C_ASM_Fragment *fragment2;
+    M3C_ASM_LEX_ACTION_CARET,
     /**
-     * \brief Preproc's stringPool.
+     * \brief `|` or `||`.
      */
-    M3C_ASM_StringPool *stringPool;
+    M3C_ASM_LEX_ACTION_PIPE,
     /**
-     * \brief Pointer to the terminating quote or `NULL` (if there is no any).
+     * \brief `~`.
      */
-    m3c_u8 const *terminatingQuotePtr;
-} M3C_ASM_Lexer;
+    M3C_ASM_LEX_ACTION_TILDE
+} M3C_ASM_LexAction;
+
+#define __ M3C_ASM_LEX_ACTION_UNRECOGNIZED
+#define LF M3C_ASM_LEX_ACTION_LF
+#define CR M3C_ASM_LEX_ACTION_CR
+#define EX M3C_ASM_LEX_ACTION_EXCLAIM
+#define QU M3C_ASM_LEX_ACTION_STRING
+#define PC M3C_ASM_LEX_ACTION_PERCENT
+#define AM M3C_ASM_LEX_ACTION_AMP
+#define LP M3C_ASM_LEX_ACTION_L_PAREN
+#define RP M3C_ASM_LEX_ACTION_R_PAREN
+#define ST M3C_ASM_LEX_ACTION_STAR
+#define PL M3C_ASM_LEX_ACTION_PLUS
+#define CM M3C_ASM_LEX_ACTION_COMMA
+#define MI M3C_ASM_LEX_ACTION_MINUS
+#define SL M3C_ASM_LEX_ACTION_SLASH
+#define Z0 M3C_ASM_LEX_ACTION_ZERO
+#define DG M3C_ASM_LEX_ACTION_DIGIT
+#define CL M3C_ASM_LEX_ACTION_COLON
+#define SC M3C_ASM_LEX_ACTION_COMMENT
+#define LT M3C_ASM_LEX_ACTION_LESS
+#define EQ M3C_ASM_LEX_ACTION_EQUAL
+#define GT M3C_ASM_LEX_ACTION_GREATER
+#define QM M3C_ASM_LEX_ACTION_QUESTION
+#define SY M3C_ASM_LEX_ACTION_SYMBOL
+#define CA M3C_ASM_LEX_ACTION_CARET
+#define PI M3C_ASM_LEX_ACTION_PIPE
+#define TI M3C_ASM_LEX_ACTION_TILDE
 
 /**
- * \brief Checks if the given `cp` is in the given `ranges`.
+ * \brief \ref M3C_ASM_LexAction "Action" for each first byte of the token.
  *
- * \param[in] ranges    pointer the the range buffer
- * \param     rangesLen number of ranges in the buffer
- * \param     cp        code point
+ * \note Stored as bytes to keep the table in a few cache lines.
  */
-m3c_bool match(M3C_ASM_ASCIIRange const *ranges, m3c_u8 rangesLen, M3C_UCP cp) {
-    M3C_ASM_ASCIIRange const *afterEnd = ranges + rangesLen;
-    for (; ranges < afterEnd; ++ranges) {
-        if (M3C_InRange(cp, ranges->lo, ranges->hi))
-            return m3c_true;
+m3c_u8 const __M3C_ASM_LEX_ACTIONS[256] = {
+    /* 0x00 */ __, __, __, __, __, __, __, __, __, __, LF, __, __, CR, __, __,
+    /* 0x10 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0x20 */ __, EX, QU, __, __, PC, AM, __, LP, RP, ST, PL, CM, MI, __, SL,
+    /* 0x30 */ Z0, DG, DG, DG, DG, DG, DG, DG, DG, DG, CL, SC, LT, EQ, GT, QM,
+    /* 0x40 */ __, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY,
+    /* 0x50 */ SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, __, __, __, CA, SY,
+    /* 0x60 */ __, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY,
+    /* 0x70 */ SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, SY, __, PI, __, TI, __,
+    /* 0x80 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0x90 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xA0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xB0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xC0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xD0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xE0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __,
+    /* 0xF0 */ __, __, __, __, __, __, __, __, __, __, __, __, __, __, __, __
+};
+
+#undef __
+#undef LF
+#undef CR
+#undef EX
+#undef QU
+#undef PC
+#undef AM
+#undef LP
+#undef RP
+#undef ST
+#undef PL
+#undef CM
+#undef MI
+#undef SL
+#undef Z0
+#undef DG
+#undef CL
+#undef SC
+#undef LT
+#undef EQ
+#undef GT
+#undef QM
+#undef SY
+#undef CA
+#undef PI
+#undef TI
+
+#define M3C_GetHexVal(cp) M3C_InRange(cp, '0', '9') ? cp - '0' : (cp & 0x1F) + 9
+
+#define M3C_BIN_PREFIX(cp) ((cp) == 'b' || (cp) == 'B' || (cp) == 'y' || (cp) == 'Y')
+#define M3C_OCT_PREFIX(cp) ((cp) == 'o' || (cp) == 'O' || (cp) == 'q' || (cp) == 'Q')
+#define M3C_DEC_PREFIX(cp) ((cp) == 'd' || (cp) == 'D')
+#define M3C_HEX_PREFIX(cp) ((cp) == 'x' || (cp) == 'X' || (cp) == 'h' || (cp) == 'H')
+
+/**
+ * \brief Reads the code point pointed to by the lexer (inside the current fragment).
+ *
+ * \details If the document is known to be valid UTF-8, code points aren't validated again: the
+ * length is taken from the lead byte.
+ *
+ * \see #M3C_UTF8GetASCIICodepointWithLen
+ */
+M3C_ERROR __M3C_ASM_Lexer_read(M3C_ASM_Lexer *lexer, M3C_UCP *cp, m3c_size_t *cpLen) {
+    if (lexer->isValidUTF8) {
+        *cp = *lexer->ptr < 0x80 ? *lexer->ptr : M3C_REPLACEMENT_CHARACTER_UCP;
+        *cpLen = M3C_UTF8_LEAD_BLEN(*lexer->ptr);
+
+        return M3C_ERROR_OK;
     }
-    return m3c_false;
+
+    return M3C_UTF8GetASCIICodepointWithLen(lexer->ptr, lexer->fragment->bLast, cp, cpLen);
+}
+
+m3c_bool __M3C_ASM_Lexer_SplitMore(M3C_ASM_Lexer *lexer) {
+    m3c_size_t n;
+
+    n = __M3C_ASM_LineSplitter_Split(&lexer->splitter, lexer->window, M3C_ASM_LEXER_WINDOW_LEN);
+    if (n == 0)
+        return m3c_false;
+
+    lexer->fragment = lexer->window;
+    lexer->fragmentLast = &lexer->window[n - 1];
+    return m3c_true;
 }
 
 /**
@@ -317,54 +533,30 @@ m3c_bool match(M3C_ASM_ASCIIRange const *ranges, m3c_u8 rangesLen, M3C_UCP cp) {
 M3C_ERROR __M3C_ASM_Lexer_peek(M3C_ASM_Lexer *lexer, M3C_UCP *cp, m3c_size_t *cpLen) {
     if (lexer->ptr <= lexer->fragment->bLast)
         /* if it's not the end of the fragment just read the next char */
-        return M3C_UTF8GetASCIICodepointWithLen(lexer->ptr, lexer->fragment->bLast, cp, cpLen);
+        return __M3C_ASM_Lexer_read(lexer, cp, cpLen);
 
     /* looking for the next non-empty fragment */
     M3C_LOOP {
-        if (lexer->fragment == lexer->fragmentLast)
+        if (lexer->fragment != lexer->fragmentLast)
+            ++lexer->fragment;
+        else if (!__M3C_ASM_Lexer_SplitMore(lexer))
             return M3C_ERROR_EOF;
-        ++lexer->fragment;
 
         if (lexer->fragment->bLast != M3C_NULL)
             break;
     }
 
     lexer->ptr = lexer->fragment->bFirst;
-    lexer->pos = lexer->fragment->pos;
-    return M3C_UTF8GetASCIICodepointWithLen(lexer->ptr, lexer->fragment->bLast, cp, cpLen);
-}
-
-M3C_ERROR __M3C_ASM_Lexer_peek2(
-    const m3c_u8 **ptr, M3C_ASM_Position *pos, M3C_ASM_Fragment **fragment,
-    const M3C_ASM_Fragment *lastFragment, M3C_UCP *cp, m3c_size_t *cpLen
-) {
-    if (*ptr <= (*fragment)->bLast)
-        /* if it's not the end of the fragment just read the next char */
-        return M3C_UTF8ReadCodepointWithLen(*ptr, (*fragment)->bLast, cp, cpLen);
-
-    /* looking for the next non-empty fragment */
-    M3C_LOOP {
-        if (*fragment == lastFragment)
-            return M3C_ERROR_EOF;
-        ++(*fragment);
-
-        if ((*fragment)->bLast != M3C_NULL)
-            break;
-    }
-
-    *ptr = (*fragment)->bFirst;
-    *pos = (*fragment)->pos;
-    return M3C_UTF8ReadCodepointWithLen(*ptr, (*fragment)->bLast, cp, cpLen);
+    return __M3C_ASM_Lexer_read(lexer, cp, cpLen);
 }
 
 /**
- * \brief Reads the document while each code point is in the given `ranges`.
+ * \brief Reads the document while each code point is in any of the character classes of `mask`.
  *
- * \param[in,out] lexer     lexer
- * \param[in]     ranges    pointer to the first range to check against
- * \param[in]     rangesLen number of `ranges`
- * \param[out]    n         writes here the number of read code points
- * \param[in]     maxN      maximum number of code points
+ * \param[in,out] lexer lexer
+ * \param         mask  `M3C_ASM_CHAR_CLASS_*` bitmask
+ * \param[out]    n     writes here the number of read code points
+ * \param[in]     maxN  maximum number of code points
  * \return
  * + #M3C_ERROR_OK - if after the matching sequence (which can have len=0) there is at least one
  * valid code point
@@ -373,17 +565,30 @@ M3C_ERROR __M3C_ASM_Lexer_peek2(
  */
 M3C_ERROR
 __M3C_ASM_lexWhile(
-    M3C_ASM_Lexer *lexer, M3C_ASM_ASCIIRange const *ranges, m3c_u8 rangesLen, m3c_size_t *n,
-    m3c_size_t maxN
+    M3C_ASM_Lexer *lexer, m3c_u16 mask, m3c_size_t *n, m3c_size_t maxN
 ) {
     __VAR_DECL_WITHOUT_N;
+    m3c_u8 const *ptr;
+    m3c_u8 const *bLast;
 
     *n = 0;
     while (*n < maxN) {
+        /* fast path: ASCII bytes of the current fragment (non-ASCII bytes have no classes) */
+        ptr = lexer->ptr;
+        bLast = lexer->fragment->bLast;
+        while (bLast && ptr <= bLast && *n < maxN && M3C_ASM_ByteIs(*ptr, mask)) {
+            ++ptr;
+            ++*n;
+        }
+        lexer->ptr = ptr;
+
+        if (*n >= maxN)
+            break;
+
         PEEK;
 
         if (status == M3C_ERROR_OK) {
-            if (match(ranges, rangesLen, cp)) {
+            if (M3C_ASM_CharIs(cp, mask)) {
                 ++*n;
                 ADVANCE;
                 continue;
@@ -437,31 +642,7 @@ M3C_ERROR __M3C_ASM_lexUnrecognisedToken(M3C_ASM_Lexer *lexer) {
         if (status == M3C_ERROR_EOF)
             break;
         else if (status == M3C_ERROR_OK) {
-            if (cp == '\n' || cp == '\r' ||  /* EOL */
-                cp == '\t' || cp == ' ' ||   /* whitespaces */
-                cp == ';' ||                 /* comment */
-                M3C_InRange(cp, '0', '9') || /* number */
-                M3C_InRange_LETTER(cp) ||    /* symbol */
-                cp == '_' ||                 /* symbol */
-                cp == '"' ||                 /* string */
-                cp == '(' || cp == ')' ||    /* parentheses */
-                cp == ',' ||                 /* comma */
-                cp == ':' ||                 /* colon */
-                cp == '+' ||                 /* plus */
-                cp == '-' ||                 /* minus */
-                cp == '*' ||                 /* star */
-                cp == '/' ||                 /* slash */
-                cp == '%' ||                 /* percent */
-                cp == '~' ||                 /* tilde */
-                cp == '&' ||                 /* amp, ampamp */
-                cp == '|' ||                 /* pipe, pipepipe */
-                cp == '^' ||                 /* caret */
-                cp == '<' ||                 /* less, ltlt, lessequal */
-                cp == '=' ||                 /* equalequal */
-                cp == '>' ||                 /* greater, gtgt, greaterequal */
-                cp == '!' ||                 /* exclaim, exclaimequal */
-                cp == '?'                    /* question */
-            )
+            if (M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_TOKEN_BOUNDARY))
                 break;
             else {
                 ADVANCE;
@@ -522,6 +703,7 @@ M3C_ERROR __M3C_ASM_lexCommentToken(M3C_ASM_Lexer *lexer) {
 
     /* looking for EOL or EOF */
     M3C_LOOP {
+        SKIP_ASCII_SCAN(M3C_ASM_CHAR_CLASS_TEXT, M3C_Scan_SkipText);
         PEEK;
 
         if (status == M3C_ERROR_EOF)
@@ -581,9 +763,7 @@ M3C_ERROR __M3C_ASM_lexNumberUntilEnd(M3C_ASM_Lexer *lexer) {
     TOK_KIND(M3C_ASM_TOKEN_KIND_UNRECOGNIZED);
 
     /* NOTE: ignore status and n */
-    __M3C_ASM_lexWhile(
-        lexer, UNDERSCORE_DIGITS_LETTERS, UNDERSCORE_DIGITS_LETTERS_LEN, &n, M3C_ASM_Token_MAX_CLEN
-    );
+    __M3C_ASM_lexWhile(lexer, M3C_ASM_CHAR_CLASS_SYMBOL_BODY, &n, M3C_ASM_Token_MAX_CLEN);
 
     TOK_END;
 
@@ -593,138 +773,92 @@ M3C_ERROR __M3C_ASM_lexNumberUntilEnd(M3C_ASM_Lexer *lexer) {
 }
 
 /**
- * \brief Fills the lexeme of \ref M3C_ASM_TOKEN_KIND_NUMBER "number" token.
- *
- * \details Diagnostics:
- * + (possible) \ref M3C_ASM_DIAGNOSTIC_ID_NUMBER_CONSTANT_IS_TOO_LARGE
- * "NUMBER_CONSTANT_IS_TOO_LARGE"
+ * \brief Appends the digit `CH` to the value of the number literal being lexed (`num` with the base
+ * `base`). If the value doesn't fit into #m3c_i32, sets `isTooLarge` instead.
  *
- * \param[in,out] lexer lexer
- * \return
- * + M3C_ERROR_OK
- * + #M3C_ERROR_OOM - if failed to push diagnostic
+ * \warning Requires `num`, `base`, `maxNumBeforeMult` (`M3C_I32_MAX / base`) and `isTooLarge`
+ * variables.
  */
-M3C_ERROR __M3C_ASM_lexemizeNumber(M3C_ASM_Lexer *lexer) {
-    VAR_DECL;
-
-    M3C_Diagnostic diagNumberConstantIsTooLarge;
-
-    int base;
-    m3c_bool isBaseSet;
-    m3c_i32 maxValueBeforeBaseMultOverflow;
-
-    int chDigitVal;
-
-    diagNumberConstantIsTooLarge.severity = M3C_SEVERITY_ERROR;
-    diagNumberConstantIsTooLarge.info = &M3C_ASM_DIAGNOSTIC_INFO_NUMBER_CONSTANT_IS_TOO_LARGE;
-
-    base = 10;
-    maxValueBeforeBaseMultOverflow = M3C_I32_MAX / base;
-    isBaseSet = m3c_false;
-
-    lexer->token.lexeme.num = 0;
-
-    while (lexer->ptr2 < lexer->ptr) {
-        PEEK2;
-
-        /* if we haven't set base yet, check for base first */
-        if (!isBaseSet) {
-            if (M3C_BIN_PREFIX(cp)) {
-                base = 2;
-                maxValueBeforeBaseMultOverflow = M3C_I32_MAX / base;
-                isBaseSet = m3c_true;
-                ADVANCE2;
-                continue;
-            } else if (M3C_OCT_PREFIX(cp)) {
-                base = 8;
-                maxValueBeforeBaseMultOverflow = M3C_I32_MAX / base;
-                isBaseSet = m3c_true;
-                ADVANCE2;
-                continue;
-            } else if (M3C_DEC_PREFIX(cp)) {
-                base = 10;
-                maxValueBeforeBaseMultOverflow = M3C_I32_MAX / base;
-                isBaseSet = m3c_true;
-                ADVANCE2;
-                continue;
-            } else if (M3C_HEX_PREFIX(cp)) {
-                base = 16;
-                maxValueBeforeBaseMultOverflow = M3C_I32_MAX / base;
-                isBaseSet = m3c_true;
-                ADVANCE2;
-                continue;
-            }
-        }
-
-        /* HACK: as we assume that the token is valid NUMBER, so we can only encounter:
-         *   1. zero (right before the base prefix)
-         *   2. digit with the `base` base
-         *   3. char '_' (which we can just ignore)
-         */
-        if (cp != '_') {
-            if (lexer->token.lexeme.num > maxValueBeforeBaseMultOverflow)
-                goto push_diag_and_return;
-            lexer->token.lexeme.num *= base;
-
-            chDigitVal = cp > '9' ? (cp & 0x1F) + 9 : cp - '0';
-            if (lexer->token.lexeme.num > M3C_I32_MAX - chDigitVal)
-                goto push_diag_and_return;
-            lexer->token.lexeme.num += chDigitVal;
-        }
-
-        ADVANCE2;
-    }
-
-    return M3C_ERROR_OK;
-
-push_diag_and_return:
-    TOK_KIND(M3C_ASM_TOKEN_KIND_UNRECOGNIZED);
-    lexer->token.lexeme.num = 0;
-
-    DIAG_START_FROM_TOKEN(&diagNumberConstantIsTooLarge);
-    DIAG_END(&diagNumberConstantIsTooLarge);
-
-    if (M3C_VEC_PUSH(M3C_Diagnostic, &lexer->diagnostics->vec, &diagNumberConstantIsTooLarge) !=
-        M3C_ERROR_OK)
-        return M3C_ERROR_OOM;
-    ++lexer->diagnostics->errors;
-
-    return M3C_ERROR_OK;
-}
+#define NUM_PUSH_DIGIT(CH)                                                                         \
+    do {                                                                                           \
+        int _digit = (CH) > '9' ? ((CH) & 0x1F) + 9 : (CH) - '0';                                  \
+                                                                                                   \
+        if (isTooLarge)                                                                            \
+            break;                                                                                 \
+        if (num > maxNumBeforeMult || num * base > M3C_I32_MAX - _digit)                           \
+            isTooLarge = m3c_true;                                                                 \
+        else                                                                                       \
+            num = num * base + _digit;                                                             \
+    } while (0)
 
 /**
  * \brief Lexes the number body.
  *
  * \details Lexes the `[_\d]` part of the number literal, where the actual `\d` is specified by
- * `rangesLen`. Also takes into account if there is some `[_0-9A-Za-z]` right after the `[_\d]`
+ * `digits`. Also takes into account if there is some `[_0-9A-Za-z]` right after the `[_\d]`
  * part, which is illegal.
  *
+ * The value of the literal is accumulated while lexing, so the lexeme is filled without rereading
+ * the literal.
+ *
  * Diagnostics:
  * + (possible) \ref M3C_ASM_DIAGNOSTIC_ID_INVALID_DIGIT_FOR_THIS_BASE_PREFIX
  * "INVALID_DIGIT_FOR_THIS_BASE_PREFIX"
  * + (possible) \ref M3C_ASM_DIAGNOSTIC_ID_NUMBER_CONSTANT_IS_TOO_LARGE
  * "NUMBER_CONSTANT_IS_TOO_LARGE"
  *
- * \param[in,out] lexer     lexer
- * \param         rangesLen one of the #UNDERSCORE_DIGITS lengths
+ * \param[in,out] lexer  lexer
+ * \param         digits one of the `M3C_ASM_CHAR_CLASS_DIGIT_*` classes
+ * \param         base   base of the base prefix or `0` if there is no prefix (decimal)
+ * \param         num    value of the already lexed digits
  * \return
  * + #M3C_ERROR_OK
  * + #M3C_ERROR_OOM - if failed to push token or diagnostic
  */
-M3C_ERROR __M3C_ASM_lexNumberBody(M3C_ASM_Lexer *lexer, m3c_u8 rangesLen) {
+M3C_ERROR __M3C_ASM_lexNumberBody(M3C_ASM_Lexer *lexer, m3c_u16 digits, int base, m3c_i32 num) {
     VAR_DECL;
 
     M3C_Diagnostic diagInvalidDigitForThisBasePrefix;
+    M3C_Diagnostic diagNumberConstantIsTooLarge;
+
+    m3c_u16 mask = digits | M3C_ASM_CHAR_CLASS_UNDERSCORE;
+    m3c_u8 const *ptr;
+    m3c_u8 const *bLast;
+
+    m3c_bool isBaseSet = base != 0;
+    m3c_bool isTooLarge = m3c_false;
+    m3c_i32 maxNumBeforeMult;
+
     diagInvalidDigitForThisBasePrefix.severity = M3C_SEVERITY_ERROR;
     diagInvalidDigitForThisBasePrefix.info =
         &M3C_ASM_DIAGNOSTIC_INFO_INVALID_DIGIT_FOR_THIS_BASE_PREFIX;
+    diagNumberConstantIsTooLarge.severity = M3C_SEVERITY_ERROR;
+    diagNumberConstantIsTooLarge.info = &M3C_ASM_DIAGNOSTIC_INFO_NUMBER_CONSTANT_IS_TOO_LARGE;
 
-    /**
-     * NOTE: we intentionally ignore:
-     *     1. status of lexWhile
-     *     2. `n`
-     */
-    __M3C_ASM_lexWhile(lexer, UNDERSCORE_DIGITS, rangesLen, &n, M3C_ASM_Token_MAX_CLEN);
+    if (!isBaseSet)
+        base = 10;
+    maxNumBeforeMult = M3C_I32_MAX / base;
+
+    /* NOTE: as #__M3C_ASM_lexWhile but the digits are also accumulated */
+    M3C_LOOP {
+        /* fast path: ASCII bytes of the current fragment */
+        ptr = lexer->ptr;
+        bLast = lexer->fragment->bLast;
+        while (bLast && ptr <= bLast && M3C_ASM_ByteIs(*ptr, mask)) {
+            if (*ptr != '_')
+                NUM_PUSH_DIGIT(*ptr);
+            ++ptr;
+        }
+        lexer->ptr = ptr;
+
+        PEEK;
+        if (status != M3C_ERROR_OK || !M3C_ASM_CharIs(cp, mask))
+            break;
+
+        if (cp != '_')
+            NUM_PUSH_DIGIT(cp);
+        ADVANCE;
+    }
 
     DIAG_START_FROM_LEXER(&diagInvalidDigitForThisBasePrefix);
 
@@ -733,17 +867,32 @@ M3C_ERROR __M3C_ASM_lexNumberBody(M3C_ASM_Lexer *lexer, m3c_u8 rangesLen) {
      * case, the number literal is no longer valid and we must continue to the end of the
      * sequence.
      *
-     * NOTE: we intentionally ignore status of lexWhile.
+     * NOTE: the value is still accumulated to report too large constants. A literal without a base
+     * prefix takes the first prefix letter here as its base prefix.
      */
-    __M3C_ASM_lexWhile(
-        lexer, UNDERSCORE_DIGITS_LETTERS, UNDERSCORE_DIGITS_LETTERS_LEN, &n, M3C_ASM_Token_MAX_CLEN
-    );
+    n = 0;
+    M3C_LOOP {
+        PEEK;
+        if (status != M3C_ERROR_OK || !M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_SYMBOL_BODY))
+            break;
+
+        if (!isBaseSet && (M3C_BIN_PREFIX(cp) || M3C_OCT_PREFIX(cp) || M3C_DEC_PREFIX(cp) ||
+                           M3C_HEX_PREFIX(cp))) {
+            base = M3C_BIN_PREFIX(cp) ? 2 : M3C_OCT_PREFIX(cp) ? 8 : M3C_DEC_PREFIX(cp) ? 10 : 16;
+            maxNumBeforeMult = M3C_I32_MAX / base;
+            isBaseSet = m3c_true;
+        } else if (cp != '_')
+            NUM_PUSH_DIGIT(cp);
+
+        ++n;
+        ADVANCE;
+    }
     if (n != 0) {
         TOK_KIND(M3C_ASM_TOKEN_KIND_UNRECOGNIZED);
 
+        /* NOTE: the diagnostic covers only the first invalid character, which is ASCII */
         diagInvalidDigitForThisBasePrefix.data.ASM.end =
-            diagInvalidDigitForThisBasePrefix.data.ASM.start;
-        ++diagInvalidDigitForThisBasePrefix.data.ASM.end.character;
+            diagInvalidDigitForThisBasePrefix.data.ASM.start + 1;
 
         if (M3C_VEC_PUSH(
                 M3C_Diagnostic, &lexer->diagnostics->vec, &diagInvalidDigitForThisBasePrefix
@@ -755,7 +904,20 @@ M3C_ERROR __M3C_ASM_lexNumberBody(M3C_ASM_Lexer *lexer, m3c_u8 rangesLen) {
 
     TOK_END;
 
-    __M3C_ASM_lexemizeNumber(lexer);
+    if (isTooLarge) {
+        TOK_KIND(M3C_ASM_TOKEN_KIND_UNRECOGNIZED);
+        lexer->token.lexeme.num = 0;
+
+        DIAG_START_FROM_TOKEN(&diagNumberConstantIsTooLarge);
+        DIAG_END(&diagNumberConstantIsTooLarge);
+
+        if (M3C_VEC_PUSH(
+                M3C_Diagnostic, &lexer->diagnostics->vec, &diagNumberConstantIsTooLarge
+            ) != M3C_ERROR_OK)
+            return M3C_ERROR_OOM;
+        ++lexer->diagnostics->errors;
+    } else
+        lexer->token.lexeme.num = num;
 
     if (TOK_PUSH != M3C_ERROR_OK)
         return M3C_ERROR_OOM;
@@ -779,16 +941,14 @@ M3C_ERROR __M3C_ASM_lexNumberBody(M3C_ASM_Lexer *lexer, m3c_u8 rangesLen) {
  * + (possible) \ref M3C_ASM_DIAGNOSTIC_ID_NUMBER_CONSTANT_IS_TOO_LARGE
  * "NUMBER_CONSTANT_IS_TOO_LARGE"
  *
- * \param[in,out] lexer                      lexer
- * \param         digitRangeLen              one of the #DIGITS lengths
- * \param         underscoreAndDigitRangeLen one of the #UNDERSCORE_DIGITS lengths
+ * \param[in,out] lexer  lexer
+ * \param         digits one of the `M3C_ASM_CHAR_CLASS_DIGIT_*` classes
+ * \param         base   base of the base prefix
  * \return
  * + #M3C_ERROR_OK
  * + #M3C_ERROR_OOM - if failed to push token or diagnostic
  */
-M3C_ERROR __M3C_ASM_lexNumberAfterPrefix(
-    M3C_ASM_Lexer *lexer, m3c_u8 digitRangeLen, m3c_u8 underscoreAndDigitRangeLen
-) {
+M3C_ERROR __M3C_ASM_lexNumberAfterPrefix(M3C_ASM_Lexer *lexer, m3c_u16 digits, int base) {
     VAR_DECL;
     M3C_Diagnostic diagUnknownBasePrefix;
     M3C_Diagnostic diagDigitSeparatorCannotAppearHere;
@@ -831,7 +991,9 @@ M3C_ERROR __M3C_ASM_lexNumberAfterPrefix(
 
         return __M3C_ASM_lexNumberUntilEnd(lexer);
 
-    } else if (status == M3C_ERROR_OK && match(DIGITS_LETTERS, DIGITS_LETTERS_LEN, cp) && !match(DIGITS, digitRangeLen, cp)) {
+    } else if (status == M3C_ERROR_OK &&
+               M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_DIGIT_DEC | M3C_ASM_CHAR_CLASS_LETTER) &&
+               !M3C_ASM_CharIs(cp, digits)) {
         DIAG_START_FROM_LEXER(&diagInvalidDigitForThisBasePrefix);
         ADVANCE;
         DIAG_END(&diagInvalidDigitForThisBasePrefix);
@@ -844,7 +1006,7 @@ M3C_ERROR __M3C_ASM_lexNumberAfterPrefix(
 
         return __M3C_ASM_lexNumberUntilEnd(lexer);
 
-    } else if ((status == M3C_ERROR_OK && !match(DIGITS, digitRangeLen, cp)) || status != M3C_ERROR_OK) {
+    } else if ((status == M3C_ERROR_OK && !M3C_ASM_CharIs(cp, digits)) || status != M3C_ERROR_OK) {
         DIAG_START_FROM_TOKEN(&diagNumberLiteralMustContainAtLeastOneDigit);
         DIAG_END(&diagNumberLiteralMustContainAtLeastOneDigit);
 
@@ -865,7 +1027,7 @@ M3C_ERROR __M3C_ASM_lexNumberAfterPrefix(
      * but we already handled case when '_' is located right after the base prefix so we can
      * just lexWhile `[_\d]*`.
      */
-    return __M3C_ASM_lexNumberBody(lexer, underscoreAndDigitRangeLen);
+    return __M3C_ASM_lexNumberBody(lexer, digits, base, 0);
 }
 
 /**
@@ -895,8 +1057,6 @@ M3C_ERROR __M3C_ASM_lexNumberAfterPrefix(
  */
 M3C_ERROR __M3C_ASM_lexZero(M3C_ASM_Lexer *lexer) {
     VAR_DECL;
-    m3c_u8 digitsLen;
-    m3c_u8 underscoreDigitsLen;
 
     M3C_Diagnostic diagUnknownBasePrefix;
     M3C_Diagnostic diagDigitSeparatorCannotAppearHere;
@@ -943,36 +1103,24 @@ M3C_ERROR __M3C_ASM_lexZero(M3C_ASM_Lexer *lexer) {
     if (M3C_BIN_PREFIX(cp)) {
         /* binary */
 
-        digitsLen = DIGITS_LEN_BIN;
-        underscoreDigitsLen = UNDERSCORE_DIGITS_LEN_BIN;
-
         ADVANCE;
-        return __M3C_ASM_lexNumberAfterPrefix(lexer, digitsLen, underscoreDigitsLen);
+        return __M3C_ASM_lexNumberAfterPrefix(lexer, M3C_ASM_CHAR_CLASS_DIGIT_BIN, 2);
     } else if (M3C_OCT_PREFIX(cp)) {
         /* octal */
 
-        digitsLen = DIGITS_LEN_OCT;
-        underscoreDigitsLen = UNDERSCORE_DIGITS_LEN_OCT;
-
         ADVANCE;
-        return __M3C_ASM_lexNumberAfterPrefix(lexer, digitsLen, underscoreDigitsLen);
+        return __M3C_ASM_lexNumberAfterPrefix(lexer, M3C_ASM_CHAR_CLASS_DIGIT_OCT, 8);
     } else if (M3C_DEC_PREFIX(cp)) {
         /* decimal */
 
-        digitsLen = DIGITS_LEN_DEC;
-        underscoreDigitsLen = UNDERSCORE_DIGITS_LEN_DEC;
-
         ADVANCE;
-        return __M3C_ASM_lexNumberAfterPrefix(lexer, digitsLen, underscoreDigitsLen);
+        return __M3C_ASM_lexNumberAfterPrefix(lexer, M3C_ASM_CHAR_CLASS_DIGIT_DEC, 10);
     } else if (M3C_HEX_PREFIX(cp)) {
         /* hex */
 
-        digitsLen = DIGITS_LEN_HEX;
-        underscoreDigitsLen = UNDERSCORE_DIGITS_LEN_HEX;
-
         ADVANCE;
-        return __M3C_ASM_lexNumberAfterPrefix(lexer, digitsLen, underscoreDigitsLen);
-    } else if ((cp >= '0' && cp <= '9') || cp == '_') {
+        return __M3C_ASM_lexNumberAfterPrefix(lexer, M3C_ASM_CHAR_CLASS_DIGIT_HEX, 16);
+    } else if (M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_DIGIT_DEC | M3C_ASM_CHAR_CLASS_UNDERSCORE)) {
         DIAG_START_FROM_LEXER(&diagLeadingZerosAreNotPermitted);
         ADVANCE;
         DIAG_END(&diagLeadingZerosAreNotPermitted);
@@ -985,7 +1133,7 @@ M3C_ERROR __M3C_ASM_lexZero(M3C_ASM_Lexer *lexer) {
 
         return __M3C_ASM_lexNumberUntilEnd(lexer);
 
-    } else if (M3C_InRange_LETTER(cp)) {
+    } else if (M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_LETTER)) {
 
         DIAG_START_FROM_LEXER(&diagUnknownBasePrefix);
         ADVANCE;
@@ -1010,6 +1158,28 @@ M3C_ERROR __M3C_ASM_lexZero(M3C_ASM_Lexer *lexer) {
     }
 }
 
+/**
+ * \brief Appends `n` bytes to the lexeme of the \ref M3C_ASM_TOKEN_KIND_STRING "string literal"
+ * being lexed (see \ref M3C_ASM_Lexer::str "Lexer::str").
+ *
+ * \param[in,out] lexer lexer
+ * \param[in]     bytes bytes
+ * \param         n     number of bytes
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if failed to reserve bytes in the string pool
+ */
+M3C_ERROR __M3C_ASM_Lexer_appendString(M3C_ASM_Lexer *lexer, m3c_u8 const *bytes, m3c_size_t n) {
+    lexer->str = __M3C_ASM_StringPool_Extend(lexer->stringPool, lexer->strLen, n);
+    if (!lexer->str)
+        return M3C_ERROR_OOM;
+
+    m3c_memcpy(lexer->str + lexer->strLen, bytes, n);
+    lexer->strLen += n;
+
+    return M3C_ERROR_OK;
+}
+
 /**
  * \brief Lexes the part of \ref M3C_ASM_TOKEN_KIND_STRING "string literal" where an invalid
  * character sequence is.
@@ -1061,7 +1231,9 @@ M3C_ERROR __M3C_ASM_lexStringInvalidEncodings(M3C_ASM_Lexer *lexer) {
 /**
  * \brief Lexes escape sequences in \ref M3C_ASM_TOKEN_KIND_STRING "string literal".
  *
- * \details Diagnostics:
+ * \details Appends the byte the escape sequence stands for to the string lexeme.
+ *
+ * Diagnostics:
  * + (possible) \ref M3C_ASM_DIAGNOSTIC_ID_UNKNOWN_ESCAPE_SEQUENCE
  * "UNKNOWN_ESCAPE_SEQUENCE"
  * + (possible) \ref M3C_ASM_DIAGNOSTIC_ID_X_USED_WITH_NO_FOLLOWING_HEX_DIGITS
@@ -1070,7 +1242,7 @@ M3C_ERROR __M3C_ASM_lexStringInvalidEncodings(M3C_ASM_Lexer *lexer) {
  * \param[in,out] lexer lexer
  * \return
  * + #M3C_ERROR_OK - OK or EOF is reached
- * + #M3C_ERROR_OOM - if failed to push token or diagnostic
+ * + #M3C_ERROR_OOM - if failed to push diagnostic or to append to the lexeme
  */
 M3C_ERROR __M3C_ASM_lexEscapeSequence(M3C_ASM_Lexer *lexer) {
     VAR_DECL;
@@ -1078,6 +1250,8 @@ M3C_ERROR __M3C_ASM_lexEscapeSequence(M3C_ASM_Lexer *lexer) {
     M3C_Diagnostic diagUnknownEscapeSequence;
     M3C_Diagnostic diagXUsedWithNoFollowingHexDigits;
 
+    m3c_u8 byte;
+
     diagUnknownEscapeSequence.severity = M3C_SEVERITY_WARNING;
     diagUnknownEscapeSequence.info = &M3C_ASM_DIAGNOSTIC_INFO_UNKNOWN_ESCAPE_SEQUENCE;
 
@@ -1096,12 +1270,31 @@ M3C_ERROR __M3C_ASM_lexEscapeSequence(M3C_ASM_Lexer *lexer) {
         (cp == '\'' || cp == '"' || cp == '?' || cp == '\\' || cp == 'a' || cp == 'b' ||
          cp == 'f' || cp == 'n' || cp == 'r' || cp == 't' || cp == 'v')) {
         ADVANCE;
-        return M3C_ERROR_OK;
+
+        if (cp == 'a')
+            byte = 0x07;
+        else if (cp == 'b')
+            byte = 0x08;
+        else if (cp == 'f')
+            byte = 0x0C;
+        else if (cp == 'n')
+            byte = 0x0A;
+        else if (cp == 'r')
+            byte = 0x0D;
+        else if (cp == 't')
+            byte = 0x09;
+        else if (cp == 'v')
+            byte = 0x0B;
+        else
+            byte = (m3c_u8)cp; /* `'`, `"`, `?` and `\` stand for themselves */
+
+        return __M3C_ASM_Lexer_appendString(lexer, &byte, 1);
     } else if (status == M3C_ERROR_OK && cp == 'x') {
         ADVANCE;
         PEEK; /* peek the first digit */
 
-        if (status != M3C_ERROR_OK || (status == M3C_ERROR_OK && !M3C_InRange_DIGIT_HEX(cp))) {
+        if (status != M3C_ERROR_OK ||
+            (status == M3C_ERROR_OK && !M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_DIGIT_HEX))) {
             TOK_KIND(M3C_ASM_TOKEN_KIND_UNRECOGNIZED);
             DIAG_END(&diagXUsedWithNoFollowingHexDigits);
 
@@ -1116,20 +1309,22 @@ M3C_ERROR __M3C_ASM_lexEscapeSequence(M3C_ASM_Lexer *lexer) {
 
         /* Well, the first digit was a valid hex-digit */
 
+        byte = (m3c_u8)(M3C_GetHexVal(cp));
         ADVANCE;
         PEEK; /* peek the second digit (if any) */
 
-        if (status == M3C_ERROR_OK && M3C_InRange_DIGIT_HEX(cp)) {
+        if (status == M3C_ERROR_OK && M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_DIGIT_HEX)) {
             /* we don't care if there are another hex digits ahead like gcc or clang do */
 
+            byte = (m3c_u8)(byte * 16 + (M3C_GetHexVal(cp)));
             ADVANCE;
-            return M3C_ERROR_OK;
-        } else {
-            /* just return. We already have at least one hex digit after "\\x" */
-            return M3C_ERROR_OK;
         }
+        /* else: we already have at least one hex digit after "\\x" */
+
+        return __M3C_ASM_Lexer_appendString(lexer, &byte, 1);
     } else {
-        /* unknown escape sequences (and can be also EOF or an invalid encoding) */
+        /* unknown escape sequences (and can be also EOF or an invalid encoding). `\` is dropped and
+         * the code point after it is lexed as a regular one */
 
         DIAG_END(&diagUnknownEscapeSequence);
         if (M3C_VEC_PUSH(M3C_Diagnostic, &lexer->diagnostics->vec, &diagUnknownEscapeSequence) !=
@@ -1141,108 +1336,6 @@ M3C_ERROR __M3C_ASM_lexEscapeSequence(M3C_ASM_Lexer *lexer) {
     }
 }
 
-M3C_ERROR __M3C_ASM_lexemizeString(M3C_ASM_Lexer *lexer) {
-    VAR_DECL;
-
-    M3C_ASM_CachedString cachedString;
-    M3C_VEC(m3c_u8) vec;
-    int d1;
-    int d2;
-
-    vec.data = m3c_malloc(sizeof(m3c_u8) * M3C_LEX_STRING_START_CAP);
-    if (!vec.data)
-        return M3C_ERROR_OOM;
-    vec.cap = M3C_LEX_STRING_START_CAP;
-    vec.len = 0;
-
-    /* get rid of the first `"` */
-    PEEK2;
-    ADVANCE2;
-
-    /* NOTE: if string is terminated just not read the last quote. If isn't just read until end. */
-    while (lexer->ptr2 <
-           (lexer->terminatingQuotePtr == M3C_NULL ? lexer->ptr : lexer->terminatingQuotePtr)) {
-
-        PEEK2;
-
-        if (cp == '\\') {
-            ADVANCE2;
-            PEEK2;
-            if (status == M3C_ERROR_EOF)
-                break;
-
-            if (cp == '\'') {
-                cp = 0x27;
-            } else if (cp == '"') {
-                cp = 0x22;
-            } else if (cp == '?') {
-                cp = 0x3F;
-            } else if (cp == '\\') {
-                cp = 0x5C;
-            } else if (cp == 'a') {
-                cp = 0x07;
-            } else if (cp == 'b') {
-                cp = 0x08;
-            } else if (cp == 'f') {
-                cp = 0x0c;
-            } else if (cp == 'n') {
-                cp = 0x0A;
-            } else if (cp == 'r') {
-                cp = 0x0D;
-            } else if (cp == 't') {
-                cp = 0x09;
-            } else if (cp == 'v') {
-                cp = 0x0B;
-            } else if (cp == 'x') {
-                ADVANCE2;
-
-                /* NOTE: EOF here is impossible here as in this case we have kind == UNRECOGNIZED
-                 * token and do not perform lexemizing */
-                PEEK2;
-                if (M3C_InRange_DIGIT_HEX(cp)) {
-                    d1 = M3C_GetHexVal(cp);
-                    ADVANCE2;
-                    PEEK2;
-                    if (M3C_InRange_DIGIT_HEX(cp) & status == M3C_ERROR_OK) {
-                        d2 = M3C_GetHexVal(cp);
-                        cp = d1 * 16 + d2;
-                        ADVANCE2;
-                    } else
-                        cp = d1;
-
-                    if (M3C_VEC_RESERVE_EXACT(m3c_u8, &vec, vec.len + 1) != M3C_ERROR_OK) {
-                        m3c_free(vec.data);
-                        return M3C_ERROR_OOM;
-                    }
-                    vec.data[vec.len] = (m3c_u8)cp;
-                    vec.len++;
-
-                    continue;
-                }
-            }
-        }
-
-        if (M3C_VEC_RESERVE_EXACT(m3c_u8, &vec, vec.len + 4) != M3C_ERROR_OK) {
-            m3c_free(vec.data);
-            return M3C_ERROR_OOM;
-        }
-        M3C_UTF8WriteCodepointWithLen(vec.data + vec.len, vec.data + vec.cap, cp, &cpLen);
-        vec.len += cpLen;
-
-        ADVANCE2;
-    }
-
-    cachedString.ptr = vec.data;
-    cachedString.len = (m3c_u32)vec.len;
-
-    lexer->token.lexeme.hStr = (m3c_u32)lexer->stringPool->len;
-
-    if (STR_PUSH(&cachedString) != M3C_ERROR_OK)
-        return M3C_ERROR_OOM;
-
-    return M3C_ERROR_OK;
-}
-
 /**
  * \brief Lexes the \ref M3C_ASM_TOKEN_KIND_STRING "string literal".
  *
@@ -1268,6 +1361,9 @@ M3C_ERROR __M3C_ASM_lexString(M3C_ASM_Lexer *lexer) {
     VAR_DECL;
 
     M3C_Diagnostic diagUnterminatedStringLiteral;
+    M3C_ASM_CachedString cachedString;
+    m3c_u8 const *run;
+
     diagUnterminatedStringLiteral.severity = M3C_SEVERITY_WARNING;
     diagUnterminatedStringLiteral.info = &M3C_ASM_DIAGNOSTIC_INFO_UNTERMINATED_STRING_LITERAL;
 
@@ -1276,12 +1372,25 @@ M3C_ERROR __M3C_ASM_lexString(M3C_ASM_Lexer *lexer) {
     PEEK; /* re-peek '"' */
     ADVANCE;
 
+    /* NOTE: the lexeme is written right into the string pool while the literal is lexed */
+    lexer->str = __M3C_ASM_StringPool_Reserve(lexer->stringPool, 0);
+    if (!lexer->str)
+        return M3C_ERROR_OOM;
+    lexer->strLen = 0;
+
     M3C_LOOP {
+        /* NOTE: bytes of the string class stand for themselves, so they are copied as is */
+        run = lexer->ptr;
+        SKIP_ASCII_WHILE(M3C_ASM_CHAR_CLASS_STRING);
+        if (lexer->ptr != run &&
+            __M3C_ASM_Lexer_appendString(lexer, run, (m3c_size_t)(lexer->ptr - run)) !=
+                M3C_ERROR_OK)
+            return M3C_ERROR_OOM;
+
         PEEK;
 
         if (status == M3C_ERROR_OK && cp == '"') {
             /* ": EOT */
-            lexer->terminatingQuotePtr = lexer->ptr;
 
             ADVANCE;
             TOK_END;
@@ -1299,13 +1408,17 @@ M3C_ERROR __M3C_ASM_lexString(M3C_ASM_Lexer *lexer) {
         } else if (status == M3C_ERROR_OK && (cp != '\n' && cp != '\r')) {
             /* any char except `\` or `"`: any regular string char */
 
+            /* NOTE: `cp` isn't used as it may be just `�` for a valid code point (see
+             * #__M3C_ASM_Lexer_read) */
+            if (__M3C_ASM_Lexer_appendString(lexer, lexer->ptr, cpLen) != M3C_ERROR_OK)
+                return M3C_ERROR_OOM;
+
             ADVANCE;
             continue;
 
         } else if (status == M3C_ERROR_EOF || (status == M3C_ERROR_OK && (cp == '\n' || cp == '\r'))) {
             /* EOF, \n, or \r: EOT (with diagnostic) */
 
-            lexer->terminatingQuotePtr = M3C_NULL;
             DIAG_START_FROM_TOKEN(&diagUnterminatedStringLiteral);
             DIAG_END(&diagUnterminatedStringLiteral);
 
@@ -1331,8 +1444,15 @@ M3C_ERROR __M3C_ASM_lexString(M3C_ASM_Lexer *lexer) {
 
 lexemize:
     if (lexer->token.kind == M3C_ASM_TOKEN_KIND_STRING) {
+        __M3C_ASM_StringPool_Commit(lexer->stringPool, lexer->strLen);
 
-        if (__M3C_ASM_lexemizeString(lexer) != M3C_ERROR_OK)
+        cachedString.ptr = lexer->str;
+        cachedString.len = (m3c_u32)lexer->strLen;
+        cachedString.hash = 0; /* NOTE: string literals aren't interned */
+
+        lexer->token.lexeme.hStr = (m3c_u32)lexer->stringPool->strings.len;
+
+        if (STR_PUSH(&cachedString) != M3C_ERROR_OK)
             return M3C_ERROR_OOM;
     }
 
@@ -1341,56 +1461,14 @@ lexemize:
     return status; /* can be OK and EOF */
 }
 
-/**
- * \brief Fills the lexeme of \ref M3C_ASM_TOKEN_KIND_SYMBOL "symbol" token.
- *
- * \param[in,out] lexer lexer
- * \return
- * + #M3C_ERROR_OK
- * + #M3C_ERROR_OOM - if failed to push string to stringPool
- */
-M3C_ERROR __M3C_ASM_lexemizeSymbol(M3C_ASM_Lexer *lexer) {
-    VAR_DECL;
-
-    m3c_u8 *str;
-    m3c_u8 *strPtr;
-    M3C_ASM_CachedString cachedString;
-
-    /* NOTE: we can allocate more then we need here if token is splitted by line continuation
-     * sequence(s) */
-    str = m3c_malloc(sizeof(m3c_u8) * (lexer->ptr - lexer->ptr2));
-    if (!str)
-        return M3C_ERROR_OOM;
-    strPtr = str;
-
-    /* read string from document to str */
-    while (lexer->ptr2 < lexer->ptr) {
-        PEEK2;
-
-        /* NOTE: only ASCII chars can be in this token,
-         *   1. so we know that `cp` <= 127
-         *   2. so we need only one byte to represent `cp` in UTF-8 in stringPool
-         */
-        *strPtr = (m3c_u8)cp;
-        ++strPtr;
-
-        ADVANCE2;
-    }
-
-    cachedString.ptr = str;
-    cachedString.len = (m3c_u32)(strPtr - str);
-
-    lexer->token.lexeme.hStr = (m3c_u32)lexer->stringPool->len;
-
-    if (STR_PUSH(&cachedString) != M3C_ERROR_OK)
-        return M3C_ERROR_OOM;
-
-    return M3C_ERROR_OK;
-}
-
 /**
  * \brief Lexes the \ref M3C_ASM_TOKEN_KIND_SYMBOL "symbol" token.
  *
+ * \details The lexeme is filled in the same pass. If the token isn't split by line continuation
+ * sequence(s), its lexeme is just the bytes of the document, so the string pool references them
+ * instead of a copy. Otherwise the runs of the token are copied one after another (as the lexeme of
+ * a string literal is).
+ *
  * \param[in,out] lexer lexer
  * \return
  * + #M3C_ERROR_OK - OK or EOF is reached
@@ -1398,55 +1476,68 @@ M3C_ERROR __M3C_ASM_lexemizeSymbol(M3C_ASM_Lexer *lexer) {
  */
 M3C_ERROR __M3C_ASM_lexSymbol(M3C_ASM_Lexer *lexer) {
     VAR_DECL;
-
-    PEEK; /* re-peek first code point - [_A-Za-z] */
-    ADVANCE;
+    m3c_u8 const *run;
+    m3c_u8 const *runEnd;
+    m3c_bool isSplit = m3c_false;
 
     TOK_KIND(M3C_ASM_TOKEN_KIND_SYMBOL);
 
+    /* NOTE: the lexer points to the first code point - [_A-Za-z] */
+    run = lexer->ptr;
     M3C_LOOP {
+        SKIP_ASCII_WHILE(M3C_ASM_CHAR_CLASS_SYMBOL_BODY);
+        runEnd = lexer->ptr;
         PEEK;
 
-        if (status == M3C_ERROR_OK &&
-            (cp == '_' || M3C_InRange(cp, '0', '9') || M3C_InRange_LETTER(cp))) {
-            ADVANCE;
-            continue;
+        if (status != M3C_ERROR_OK || !M3C_ASM_CharIs(cp, M3C_ASM_CHAR_CLASS_SYMBOL_BODY))
+            break;
+
+        /* NOTE: the token goes on in the next fragment (only ASCII bytes can be in this token) */
+        if (!isSplit) {
+            lexer->str = __M3C_ASM_StringPool_Reserve(lexer->stringPool, 0);
+            if (!lexer->str)
+                return M3C_ERROR_OOM;
+            lexer->strLen = 0;
+            isSplit = m3c_true;
         }
+        if (__M3C_ASM_Lexer_appendString(lexer, run, (m3c_size_t)(runEnd - run)) != M3C_ERROR_OK)
+            return M3C_ERROR_OOM;
 
-        break;
+        run = lexer->ptr;
+        ADVANCE;
     }
     TOK_END;
 
-    status = __M3C_ASM_lexemizeSymbol(lexer);
+    if (!isSplit)
+        status = __M3C_ASM_StringPool_InternRef(
+            lexer->stringPool, lexer->stringRefs, run, (m3c_u32)(runEnd - run),
+            &lexer->token.lexeme.hStr
+        );
+    else if (__M3C_ASM_Lexer_appendString(lexer, run, (m3c_size_t)(runEnd - run)) != M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+    else
+        /* NOTE: the lexeme is already in the reserved bytes, so it isn't copied again */
+        status = __M3C_ASM_StringPool_Intern(
+            lexer->stringPool, lexer->str, (m3c_u32)lexer->strLen, &lexer->token.lexeme.hStr
+        );
     if (status != M3C_ERROR_OK)
         return status;
 
     return TOK_PUSH;
 }
 
-#define ONE_CHAR_TOKEN(ch, tokenKind)                                                              \
-    (cp == (ch)) {                                                                                 \
+#define ONE_CHAR_TOKEN(action, tokenKind)                                                          \
+    case M3C_ASM_LEX_ACTION_##action:                                                              \
         TOK_KIND(tokenKind);                                                                       \
-        goto one_char_token;                                                                       \
-    }
+        goto one_char_token
 
-/**
- * \brief Lexes the next token (if there is one).
- *
- * \note If EOF is reached but no token is found, #M3C_ERROR_OK is returned.
- *
- * \param[in,out] lexer
- * \return
- * + #M3C_ERROR_OK
- * + #M3C_ERROR_EOF - if EOF is reached
- * + #M3C_ERROR_OOM - if failed to push token, diagnostic, or lexeme
- */
-M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
+M3C_ERROR __M3C_ASM_Lexer_NextToken(M3C_ASM_Lexer *lexer) {
     VAR_DECL;
-    M3C_ASM_Position tempPos;
+    m3c_u8 const *tempPtr;
 
     /* skip whitespaces (only space and '\t') */
     M3C_LOOP {
+        SKIP_ASCII_SCAN(M3C_ASM_CHAR_CLASS_BLANK, M3C_Scan_SkipBlanks);
         PEEK;
         if (status == M3C_ERROR_EOF)
             return M3C_ERROR_EOF;
@@ -1457,31 +1548,31 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
     }
     TOK_START;
 
-    if (cp == '\n') {
+    /* NOTE: the lexer points to the first byte of the token (non-ASCII bytes are unrecognized) */
+    switch ((M3C_ASM_LexAction)__M3C_ASM_LEX_ACTIONS[*lexer->ptr]) {
+    case M3C_ASM_LEX_ACTION_LF:
         TOK_KIND(M3C_ASM_TOKEN_KIND_EOL);
-        ADVANCE_NL;
+        ADVANCE;
         TOK_END;
         return TOK_PUSH;
-    } else if (cp == '\r') {
+    case M3C_ASM_LEX_ACTION_CR:
         TOK_KIND(M3C_ASM_TOKEN_KIND_EOL);
         ADVANCE;
 
-        /* NOTE: store pos before PEEK, as PEEK can automatically rewrites it with pos of the next
-         * fragment (if any) */
-        tempPos = lexer->pos;
+        /* NOTE: store ptr before PEEK, as PEEK can automatically move it to the next fragment (if
+         * any) */
+        tempPtr = lexer->ptr;
         PEEK;
 
         if (status == M3C_ERROR_OK && cp == '\n') { /* \r ~ \n */
-            ADVANCE_NL;
+            ADVANCE;
             TOK_END;
             return TOK_PUSH;
         } else {
-            lexer->pos = tempPos;
-            __ADVANCE_ONLY_POS_NL;
-            TOK_END;
+            lexer->token.len = (m3c_u32)(tempPtr - lexer->bFirst) - lexer->token.offset;
             return TOK_PUSH;
         }
-    } else if (cp == '!') {
+    case M3C_ASM_LEX_ACTION_EXCLAIM:
         ADVANCE;
         PEEK;
         if (status == M3C_ERROR_OK && cp == '=') {
@@ -1492,11 +1583,9 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
             TOK_END;
             return TOK_PUSH;
         }
-    } else if (cp == '"')
+    case M3C_ASM_LEX_ACTION_STRING:
         return __M3C_ASM_lexString(lexer);
-    else if
-        ONE_CHAR_TOKEN('%', M3C_ASM_TOKEN_KIND_PERCENT)
-    else if (cp == '&') {
+    case M3C_ASM_LEX_ACTION_AMP:
         ADVANCE;
         PEEK;
         if (status == M3C_ERROR_OK && cp == '&') {
@@ -1507,30 +1596,16 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
             TOK_END;
             return TOK_PUSH;
         }
-    } else if
-        ONE_CHAR_TOKEN('(', M3C_ASM_TOKEN_KIND_L_PAREN)
-    else if
-        ONE_CHAR_TOKEN(')', M3C_ASM_TOKEN_KIND_R_PAREN)
-    else if
-        ONE_CHAR_TOKEN('*', M3C_ASM_TOKEN_KIND_STAR)
-    else if
-        ONE_CHAR_TOKEN('+', M3C_ASM_TOKEN_KIND_PLUS)
-    else if
-        ONE_CHAR_TOKEN(',', M3C_ASM_TOKEN_KIND_COMMA)
-    else if
-        ONE_CHAR_TOKEN('-', M3C_ASM_TOKEN_KIND_MINUS)
-    else if
-        ONE_CHAR_TOKEN('/', M3C_ASM_TOKEN_KIND_SLASH)
-    else if (cp == '0')
+    case M3C_ASM_LEX_ACTION_ZERO:
         return __M3C_ASM_lexZero(lexer);
-    else if (cp >= '1' && cp <= '9') {
+    case M3C_ASM_LEX_ACTION_DIGIT:
         ADVANCE;
-        return __M3C_ASM_lexNumberBody(lexer, UNDERSCORE_DIGITS_LEN_DEC);
-    } else if
-        ONE_CHAR_TOKEN (':', M3C_ASM_TOKEN_KIND_COLON)
-    else if (cp == ';')
+        return __M3C_ASM_lexNumberBody(
+            lexer, M3C_ASM_CHAR_CLASS_DIGIT_DEC, 0, (m3c_i32)(cp - '0')
+        );
+    case M3C_ASM_LEX_ACTION_COMMENT:
         return __M3C_ASM_lexCommentToken(lexer);
-    else if (cp == '<') {
+    case M3C_ASM_LEX_ACTION_LESS:
         ADVANCE;
         PEEK;
         if (status == M3C_ERROR_OK && cp == '<') {
@@ -1544,7 +1619,7 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
             TOK_END;
             return TOK_PUSH;
         }
-    } else if (cp == '=') {
+    case M3C_ASM_LEX_ACTION_EQUAL:
         ADVANCE;
         PEEK;
         if (status == M3C_ERROR_OK && cp == '=') {
@@ -1552,7 +1627,7 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
             goto one_char_token;
         } else
             return __M3C_ASM_lexUnrecognisedToken(lexer);
-    } else if (cp == '>') {
+    case M3C_ASM_LEX_ACTION_GREATER:
         ADVANCE;
         PEEK;
         if (status == M3C_ERROR_OK && cp == '>') {
@@ -1566,13 +1641,9 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
             TOK_END;
             return TOK_PUSH;
         }
-    } else if
-        ONE_CHAR_TOKEN('?', M3C_ASM_TOKEN_KIND_QUESTION)
-    else if (cp == '_' || M3C_InRange_LETTER(cp))
+    case M3C_ASM_LEX_ACTION_SYMBOL:
         return __M3C_ASM_lexSymbol(lexer);
-    else if
-        ONE_CHAR_TOKEN('^', M3C_ASM_TOKEN_KIND_CARET)
-    else if (cp == '|') {
+    case M3C_ASM_LEX_ACTION_PIPE:
         ADVANCE;
         PEEK;
         if (status == M3C_ERROR_OK && cp == '|') {
@@ -1583,10 +1654,21 @@ M3C_ERROR __M3C_ASM_lexNextToken(M3C_ASM_Lexer *lexer) {
             TOK_END;
             return TOK_PUSH;
         }
-    } else if
-        ONE_CHAR_TOKEN('~', M3C_ASM_TOKEN_KIND_TILDE)
-    else
+    ONE_CHAR_TOKEN(PERCENT, M3C_ASM_TOKEN_KIND_PERCENT);
+    ONE_CHAR_TOKEN(L_PAREN, M3C_ASM_TOKEN_KIND_L_PAREN);
+    ONE_CHAR_TOKEN(R_PAREN, M3C_ASM_TOKEN_KIND_R_PAREN);
+    ONE_CHAR_TOKEN(STAR, M3C_ASM_TOKEN_KIND_STAR);
+    ONE_CHAR_TOKEN(PLUS, M3C_ASM_TOKEN_KIND_PLUS);
+    ONE_CHAR_TOKEN(COMMA, M3C_ASM_TOKEN_KIND_COMMA);
+    ONE_CHAR_TOKEN(MINUS, M3C_ASM_TOKEN_KIND_MINUS);
+    ONE_CHAR_TOKEN(SLASH, M3C_ASM_TOKEN_KIND_SLASH);
+    ONE_CHAR_TOKEN(COLON, M3C_ASM_TOKEN_KIND_COLON);
+    ONE_CHAR_TOKEN(QUESTION, M3C_ASM_TOKEN_KIND_QUESTION);
+    ONE_CHAR_TOKEN(CARET, M3C_ASM_TOKEN_KIND_CARET);
+    ONE_CHAR_TOKEN(TILDE, M3C_ASM_TOKEN_KIND_TILDE);
+    default:
         return __M3C_ASM_lexUnrecognisedToken(lexer);
+    }
 
 /* Not for EOL */
 one_char_token:
@@ -1595,31 +1677,57 @@ one_char_token:
     return TOK_PUSH;
 }
 
+void __M3C_ASM_Lexer_InitCommon(
+    M3C_ASM_Lexer *lexer, M3C_ASM_PreProc *preproc, M3C_ASM_Document *document
+) {
+    lexer->stringPool = &preproc->stringPool;
+    lexer->stringRefs = &document->stringRefs;
+
+    lexer->ptr = document->bFirst;
+    lexer->bFirst = document->bFirst;
+
+    lexer->diagnostics = &document->diagnostics;
+
+    lexer->isValidUTF8 = document->encoding == M3C_ASM_DOCUMENT_ENCODING_UTF8 ||
+                         document->encoding == M3C_ASM_DOCUMENT_ENCODING_ASCII;
+}
+
+/**
+ * \brief Checks that the offsets of the document fit into `u32`.
+ */
+m3c_bool __M3C_ASM_Lexer_isTooLong(M3C_ASM_Document const *document) {
+    return document->bLast &&
+           (m3c_size_t)(document->bLast - document->bFirst) >= M3C_ASM_DOCUMENT_MAX_BLEN;
+}
+
 M3C_ERROR M3C_ASM_lex(M3C_ASM_PreProc *preproc, m3c_u32 hDocument) {
     M3C_ASM_Document *document;
     M3C_ASM_Lexer lexer;
     M3C_ERROR res;
 
     if (hDocument >= preproc->documents.len)
-    return M3C_ERROR_BAD_HANDLE;
+        return M3C_ERROR_BAD_HANDLE;
 
-    lexer.stringPool = &preproc->stringPool;
     document = &preproc->documents.data[hDocument];
 
     if (document->fragments.len == 0)
         return M3C_ERROR_OK;
+    if (__M3C_ASM_Lexer_isTooLong(document))
+        return M3C_ERROR_OOB;
+
+    __M3C_ASM_Lexer_InitCommon(&lexer, preproc, document);
+
     lexer.fragment = document->fragments.data;
     lexer.fragmentLast = &document->fragments.data[document->fragments.len - 1];
+    /* NOTE: the document is already split, so the splitter has nothing to split */
+    lexer.splitter.ptr = M3C_NULL;
 
-    lexer.pos = lexer.fragment->pos;
-    lexer.ptr = document->bFirst;
-    lexer.bLast = document->bLast;
-
-    lexer.diagnostics = &document->diagnostics;
     lexer.tokens = &document->tokens;
+    lexer.batch = M3C_NULL;
+    lexer.nTokens = document->tokens.len;
 
     M3C_LOOP {
-        res = __M3C_ASM_lexNextToken(&lexer);
+        res = __M3C_ASM_Lexer_NextToken(&lexer);
         if (res == M3C_ERROR_EOF)
             return M3C_ERROR_OK;
         else if (res != M3C_ERROR_OK)
@@ -1628,3 +1736,53 @@ M3C_ERROR M3C_ASM_lex(M3C_ASM_PreProc *preproc, m3c_u32 hDocument) {
             continue;
     }
 }
+
+M3C_ERROR M3C_ASM_Lexer_Init(
+    M3C_ASM_Lexer *lexer, M3C_ASM_PreProc *preproc, M3C_ASM_hDocument hDocument,
+    m3c_bool usePreproc
+) {
+    M3C_ASM_Document *document;
+
+    if (hDocument >= preproc->documents.len)
+        return M3C_ERROR_BAD_HANDLE;
+
+    document = &preproc->documents.data[hDocument];
+
+    if (__M3C_ASM_Lexer_isTooLong(document))
+        return M3C_ERROR_OOB;
+
+    __M3C_ASM_Lexer_InitCommon(lexer, preproc, document);
+
+    /* NOTE: even an empty document has one fragment */
+    __M3C_ASM_LineSplitter_Init(&lexer->splitter, document, usePreproc);
+    __M3C_ASM_Lexer_SplitMore(lexer);
+
+    lexer->tokens = M3C_NULL;
+    lexer->batch = M3C_NULL;
+    lexer->nTokens = 0;
+
+    return M3C_ERROR_OK;
+}
+
+M3C_ERROR M3C_ASM_Lexer_Next(
+    M3C_ASM_Lexer *lexer, M3C_ASM_Token *batch, m3c_size_t n, m3c_size_t *len
+) {
+    M3C_ERROR res = M3C_ERROR_OK;
+
+    lexer->batch = batch;
+    lexer->batchLen = 0;
+
+    /* NOTE: each call of #__M3C_ASM_Lexer_NextToken writes at most one token */
+    while (lexer->batchLen < n) {
+        res = __M3C_ASM_Lexer_NextToken(lexer);
+        if (res != M3C_ERROR_OK)
+            break;
+    }
+
+    *len = lexer->batchLen;
+    lexer->batch = M3C_NULL;
+
+    if (res == M3C_ERROR_EOF)
+        return *len ? M3C_ERROR_OK : M3C_ERROR_EOF;
+    return res;
+}
@@ -0,0 +1,372 @@
+#include <m3c/asm/plex.h>
+
+#include <m3c/common/coltypes.h>
+#include <m3c/common/macros.h>
+
+#include <m3c/rt/alloc.h>
+#include <m3c/rt/mem.h>
+#ifdef M3C_FEATURE_API_SYSCALLS
+#    include <m3c/rt/runtime.h>
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+#include <m3c/core/diagnostics.h>
+
+#include <m3c/asm/lex.h>
+#include <m3c/asm/lexer.h>
+#include <m3c/asm/tokens.h>
+
+/**
+ * \brief Worker lexing a range of the fragments (see #M3C_ASM_lexParallel).
+ */
+typedef struct __tagM3C_ASM_PLexWorker {
+    /**
+     * \brief Lexer of the range.
+     */
+    M3C_ASM_Lexer lexer;
+    /**
+     * \brief Tokens of the range (unless it's the first range, which is lexed right into the
+     * document).
+     *
+     * \details Their handles start from `0`.
+     */
+    M3C_ASM_Tokens tokens;
+    /**
+     * \brief Diagnostics of the range (unless it's the first one).
+     */
+    M3C_Diagnostics diagnostics;
+    /**
+     * \brief Lexemes of the range (unless it's the first one).
+     */
+    M3C_ASM_StringPool stringPool;
+    /**
+     * \brief Result of lexing.
+     */
+    M3C_ERROR res;
+#ifdef M3C_FEATURE_API_SYSCALLS
+    /**
+     * \brief Thread of the worker (or `NULL` if the range is lexed by the calling thread).
+     */
+    M3C_RuntimeThread *thread;
+    /**
+     * \brief State of the thread (see #M3C_Runtime_Wait).
+     *
+     * \details One of:
+     * + `0` - lexing
+     * + `1` - lexed, the results can be merged
+     * + `2` - merged, the thread deinits its buffers and finishes
+     */
+    int state;
+#endif /* M3C_FEATURE_API_SYSCALLS */
+} M3C_ASM_PLexWorker;
+
+/**
+ * \brief Returns the index of the first fragment after `from` that starts at or after the byte and
+ * at a token boundary (see #__M3C_ASM_LEXER_IS_TOKEN_BOUNDARY) or the number of fragments if there
+ * is no such fragment.
+ */
+m3c_size_t __M3C_ASM_PLex_findBoundary(
+    M3C_ASM_FragmentsCache const *fragments, m3c_size_t from, m3c_u8 const *ptr
+) {
+    m3c_size_t lo = from + 1;
+    m3c_size_t hi = fragments->len;
+    m3c_size_t mid;
+
+    /* NOTE: even empty fragments have `bFirst`, so the fragments are sorted by it */
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (fragments->data[mid].bFirst < ptr)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    while (lo < fragments->len &&
+           !__M3C_ASM_LEXER_IS_TOKEN_BOUNDARY(&fragments->data[lo - 1], &fragments->data[lo]))
+        ++lo;
+
+    return lo;
+}
+
+/**
+ * \brief Prepares the worker to lex the fragments `[first, last)`.
+ *
+ * \details The first range is lexed right into the document. The others are lexed into the buffers
+ * of the worker.
+ */
+void __M3C_ASM_PLexWorker_init(
+    M3C_ASM_PLexWorker *worker, M3C_ASM_PreProc *preproc, M3C_ASM_Document *document,
+    m3c_size_t first, m3c_size_t last
+) {
+    M3C_ASM_Lexer *lexer = &worker->lexer;
+
+    __M3C_ASM_Tokens_Init(&worker->tokens);
+    __M3C_Diagnostics_Init(&worker->diagnostics);
+    __M3C_ASM_StringPool_Init(&worker->stringPool);
+    worker->res = M3C_ERROR_OK;
+#ifdef M3C_FEATURE_API_SYSCALLS
+    worker->thread = M3C_NULL;
+    worker->state = 0;
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+    __M3C_ASM_Lexer_InitCommon(lexer, preproc, document);
+
+    lexer->fragment = &document->fragments.data[first];
+    lexer->fragmentLast = &document->fragments.data[last - 1];
+    lexer->ptr = lexer->fragment->bFirst;
+    /* NOTE: the document is already split, so the splitter has nothing to split */
+    lexer->splitter.ptr = M3C_NULL;
+    lexer->batch = M3C_NULL;
+
+    if (first == 0) {
+        lexer->tokens = &document->tokens;
+        lexer->nTokens = document->tokens.len;
+    } else {
+        lexer->tokens = &worker->tokens;
+        lexer->nTokens = 0;
+        lexer->diagnostics = &worker->diagnostics;
+        lexer->stringPool = &worker->stringPool;
+        /* NOTE: the pool of the worker dies before the document, so its strings aren't recorded */
+        lexer->stringRefs = M3C_NULL;
+    }
+}
+
+/**
+ * \brief Deinits the buffers of the worker.
+ *
+ * \note The buffers of a spawned worker are deinited by its thread, as they are in its arena.
+ */
+void __M3C_ASM_PLexWorker_deinit(M3C_ASM_PLexWorker const *worker) {
+    __M3C_ASM_Tokens_Deinit(&worker->tokens);
+    __M3C_Diagnostics_Deinit(&worker->diagnostics);
+    __M3C_ASM_StringPool_Deinit(&worker->stringPool);
+}
+
+/**
+ * \brief Lexes the range of the worker (see #M3C_ThreadProcCB).
+ *
+ * \details The result is written to \ref M3C_ASM_PLexWorker::res "res".
+ *
+ * \return `0`
+ */
+int __M3C_ASM_PLexWorker_run(void *arg) {
+    M3C_ASM_PLexWorker *worker = (M3C_ASM_PLexWorker *)arg;
+    M3C_ERROR res;
+
+    M3C_LOOP {
+        res = __M3C_ASM_Lexer_NextToken(&worker->lexer);
+        if (res != M3C_ERROR_OK)
+            break;
+    }
+
+    worker->res = res == M3C_ERROR_EOF ? M3C_ERROR_OK : res;
+
+    return 0;
+}
+
+#ifdef M3C_FEATURE_API_SYSCALLS
+/**
+ * \brief Procedure of the worker thread (see #M3C_ThreadProcCB).
+ *
+ * \details Lexes the range, then waits until the results are merged (see \ref
+ * M3C_ASM_PLexWorker::state "state") and deinits the buffers. The arena of the thread is returned
+ * to the runtime when it's joined, so nothing of it may outlive the thread.
+ *
+ * \return `0`
+ */
+int __M3C_ASM_PLexWorker_thread(void *arg) {
+    M3C_ASM_PLexWorker *worker = (M3C_ASM_PLexWorker *)arg;
+
+    __M3C_ASM_PLexWorker_run(worker);
+
+    M3C_Runtime_Signal(&worker->state, 1);
+    M3C_Runtime_Wait(&worker->state, 1);
+
+    __M3C_ASM_PLexWorker_deinit(worker);
+
+    return 0;
+}
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+/**
+ * \brief Appends the tokens and the diagnostics of the worker to the document.
+ *
+ * \details The lexemes are interned into the preproc's string pool (string literals are just pushed
+ * as they aren't interned) and the handles of the tokens are shifted. The lexemes are copied unless
+ * they reference the document buffer, so the worker's buffers can be deinited after the merge.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_PLexWorker_merge(
+    M3C_ASM_PLexWorker *worker, M3C_ASM_PreProc *preproc, M3C_ASM_Document *document
+) {
+    M3C_ASM_StringPool *pool = &preproc->stringPool;
+    M3C_ASM_StringPool *src = &worker->stringPool;
+    M3C_ASM_Tokens *tokens = &worker->tokens;
+    M3C_ASM_CachedString cachedString;
+    M3C_ASM_TokenKind kind;
+    M3C_Diagnostic *diagnostics;
+    m3c_u32 *hStrs = M3C_NULL;
+    m3c_u32 *hStr;
+    m3c_u8 *dst;
+    m3c_u32 base = (m3c_u32)document->tokens.len;
+    m3c_size_t i;
+    M3C_ERROR status;
+    M3C_ERROR res = M3C_ERROR_OOM;
+
+    if (src->strings.len) {
+        if (src->strings.len > M3C_SIZE_MAX / sizeof(m3c_u32))
+            return M3C_ERROR_OOM;
+        hStrs = (m3c_u32 *)m3c_malloc(src->strings.len * sizeof(m3c_u32));
+        if (!hStrs)
+            return M3C_ERROR_OOM;
+        m3c_memset(hStrs, 0xFF, src->strings.len * sizeof(m3c_u32));
+    }
+
+    for (i = 0; i < tokens->len; ++i) {
+        kind = M3C_ASM_TOKENS_KIND(tokens, i);
+        if (kind != M3C_ASM_TOKEN_KIND_SYMBOL && kind != M3C_ASM_TOKEN_KIND_STRING)
+            continue;
+
+        hStr = &tokens->lexemes[i].hStr;
+        if (hStrs[*hStr] == 0xFFFFFFFFU) {
+            cachedString = src->strings.data[*hStr];
+
+            if (kind == M3C_ASM_TOKEN_KIND_SYMBOL) {
+                /* NOTE: lexemes in the chunks of the worker are copied as the chunks die with it */
+                if (cachedString.ptr >= document->bFirst && cachedString.ptr <= document->bLast)
+                    status = __M3C_ASM_StringPool_InternRef(
+                        pool, &document->stringRefs, cachedString.ptr, cachedString.len,
+                        &hStrs[*hStr]
+                    );
+                else
+                    status = __M3C_ASM_StringPool_Intern(
+                        pool, cachedString.ptr, cachedString.len, &hStrs[*hStr]
+                    );
+                if (status != M3C_ERROR_OK)
+                    goto out;
+            } else {
+                dst = __M3C_ASM_StringPool_Reserve(pool, cachedString.len);
+                if (!dst)
+                    goto out;
+                m3c_memcpy(dst, cachedString.ptr, cachedString.len);
+                __M3C_ASM_StringPool_Commit(pool, cachedString.len);
+                cachedString.ptr = dst;
+
+                hStrs[*hStr] = (m3c_u32)pool->strings.len;
+                if (M3C_VEC_PUSH(M3C_ASM_CachedString, &pool->strings, &cachedString) !=
+                    M3C_ERROR_OK)
+                    goto out;
+            }
+        }
+        *hStr = hStrs[*hStr];
+    }
+
+    if (M3C_VEC_RESERVE_UNUSED(
+            M3C_Diagnostic, &document->diagnostics.vec, worker->diagnostics.vec.len
+        ) != M3C_ERROR_OK ||
+        __M3C_ASM_Tokens_Splice(&document->tokens, base, base, tokens, 0) != M3C_ERROR_OK)
+        goto out;
+
+    /* NOTE: there is room for all diagnostics. An empty vector may be `NULL` */
+    if (worker->diagnostics.vec.len) {
+        diagnostics = &document->diagnostics.vec.data[document->diagnostics.vec.len];
+        m3c_memcpy(
+            diagnostics, worker->diagnostics.vec.data,
+            worker->diagnostics.vec.len * sizeof(M3C_Diagnostic)
+        );
+        for (i = 0; i < worker->diagnostics.vec.len; ++i)
+            diagnostics[i].data.ASM.hToken += base;
+        document->diagnostics.vec.len += worker->diagnostics.vec.len;
+    }
+    document->diagnostics.warnings += worker->diagnostics.warnings;
+    document->diagnostics.errors += worker->diagnostics.errors;
+
+    res = M3C_ERROR_OK;
+
+out:
+    if (hStrs)
+        m3c_free(hStrs);
+
+    return res;
+}
+
+M3C_ERROR M3C_ASM_lexParallel(
+    M3C_ASM_PreProc *preproc, M3C_ASM_hDocument hDocument, m3c_size_t nWorkers
+) {
+    M3C_ASM_Document *document;
+    M3C_ASM_PLexWorker *workers;
+    m3c_size_t blen;
+    m3c_size_t n;
+    m3c_size_t i;
+    m3c_size_t first;
+    m3c_size_t last;
+    M3C_ERROR res;
+
+    if (hDocument >= preproc->documents.len)
+        return M3C_ERROR_BAD_HANDLE;
+
+    document = &preproc->documents.data[hDocument];
+
+    blen = document->bLast ? (m3c_size_t)(document->bLast - document->bFirst) + 1 : 0;
+    n = blen / M3C_ASM_PLEX_MIN_BLEN;
+    if (n > nWorkers)
+        n = nWorkers;
+
+    /* NOTE: a too long document is reported by #M3C_ASM_lex as well */
+    if (n <= 1 || document->fragments.len == 0 || blen > M3C_ASM_DOCUMENT_MAX_BLEN)
+        return M3C_ASM_lex(preproc, hDocument);
+
+    if (n > M3C_SIZE_MAX / sizeof(M3C_ASM_PLexWorker))
+        return M3C_ERROR_OOM;
+    workers = (M3C_ASM_PLexWorker *)m3c_malloc(n * sizeof(M3C_ASM_PLexWorker));
+    if (!workers)
+        return M3C_ERROR_OOM;
+
+    /* NOTE: a range may swallow the next ones if its last logical line is long */
+    for (i = 0, first = 0; i < n && first < document->fragments.len; ++i, first = last) {
+        last = i + 1 == n ? document->fragments.len
+                          : __M3C_ASM_PLex_findBoundary(
+                                &document->fragments, first, document->bFirst + blen / n * (i + 1)
+                            );
+        __M3C_ASM_PLexWorker_init(&workers[i], preproc, document, first, last);
+    }
+    n = i;
+
+#ifdef M3C_FEATURE_API_SYSCALLS
+    for (i = 1; i < n; ++i)
+        workers[i].thread = M3C_Runtime_SpawnThread(__M3C_ASM_PLexWorker_thread, &workers[i]);
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+    __M3C_ASM_PLexWorker_run(&workers[0]);
+    res = workers[0].res;
+
+    for (i = 1; i < n; ++i) {
+#ifdef M3C_FEATURE_API_SYSCALLS
+        if (workers[i].thread)
+            M3C_Runtime_Wait(&workers[i].state, 0);
+        else
+#endif /* M3C_FEATURE_API_SYSCALLS */
+            __M3C_ASM_PLexWorker_run(&workers[i]);
+
+        /* NOTE: the ranges are appended in order, so the tokens and the diagnostics stay sorted */
+        if (res == M3C_ERROR_OK)
+            res = workers[i].res;
+        if (res == M3C_ERROR_OK)
+            res = __M3C_ASM_PLexWorker_merge(&workers[i], preproc, document);
+
+#ifdef M3C_FEATURE_API_SYSCALLS
+        if (workers[i].thread) {
+            M3C_Runtime_Signal(&workers[i].state, 2);
+            M3C_Runtime_JoinThread(workers[i].thread);
+        } else
+#endif /* M3C_FEATURE_API_SYSCALLS */
+            __M3C_ASM_PLexWorker_deinit(&workers[i]);
+    }
+
+    __M3C_ASM_PLexWorker_deinit(&workers[0]);
+    m3c_free(workers);
+
+    return res;
+}
@@ -1,31 +1,108 @@
 #include <m3c/asm/preproc.h>
 
 #include <m3c/common/coltypes.h>
-#include <m3c/common/utf8.h>
 #include <m3c/common/macros.h>
+#include <m3c/common/utf8.h>
 
 #include <m3c/rt/alloc.h>
+#include <m3c/rt/file.h>
+#include <m3c/rt/mem.h>
+#include <m3c/rt/scan.h>
 
 #include <m3c/asm/lex.h>
+#include <m3c/asm/tokens.h>
 
 void M3C_ASM_Document_Init(M3C_ASM_Document *document, m3c_u8 const *buf, m3c_size_t bufLen) {
-    M3C_VEC_INIT(&document->tokens);
+    __M3C_ASM_Tokens_Init(&document->tokens);
     __M3C_Diagnostics_Init(&document->diagnostics);
 
     document->fragments.data = M3C_NULL;
     document->fragments.len = 0;
+    M3C_VEC_INIT(&document->stringRefs);
 
     document->bFirst = buf;
     document->bLast = bufLen > 0 ? buf + bufLen - 1 : M3C_NULL;
+
+    document->buf = M3C_ASM_DOCUMENT_BUF_BORROWED;
+    document->encoding = M3C_ASM_DOCUMENT_ENCODING_UNKNOWN;
+    document->usesPreproc = m3c_false;
+}
+
+M3C_ERROR M3C_ASM_Document_InitFromFile(M3C_ASM_Document *document, char const *path) {
+    M3C_FileMapping mapping;
+
+    if (M3C_File_Map(path, &mapping) != M3C_ERROR_OK)
+        return M3C_ERROR_IO;
+
+    M3C_ASM_Document_Init(document, mapping.ptr, mapping.len);
+    document->buf = M3C_ASM_DOCUMENT_BUF_MAPPED;
+
+    return M3C_ERROR_OK;
 }
 
 void M3C_ASM_Document_Deinit(M3C_ASM_Document const *document) {
-    M3C_VEC_DEINIT(&document->tokens);
+    M3C_FileMapping mapping;
+
+    __M3C_ASM_Tokens_Deinit(&document->tokens);
     __M3C_Diagnostics_Deinit(&document->diagnostics);
 
     M3C_ARR_DEINIT_BOXED(&document->fragments);
+    M3C_VEC_DEINIT(&document->stringRefs);
+
+    /* NOTE: no free for document buf (`::bFirst`) unless we own it */
+    if (document->buf == M3C_ASM_DOCUMENT_BUF_MAPPED) {
+        mapping.ptr = document->bFirst;
+        mapping.len = document->bLast ? (m3c_size_t)(document->bLast - document->bFirst) + 1 : 0;
+
+        M3C_File_Unmap(&mapping);
+    } else if (document->buf == M3C_ASM_DOCUMENT_BUF_ALLOCATED)
+        m3c_free((void *)document->bFirst);
+}
+
+void M3C_ASM_Document_GetPosition(
+    M3C_ASM_Document const *document, m3c_u32 offset, M3C_ASM_Position *pos
+) {
+    M3C_ASM_Fragment const *fragment;
+    m3c_u8 const *ptr = document->bFirst + offset;
+    m3c_u8 const *fragmentPtr;
+    m3c_u8 const *end;
+    m3c_size_t lo = 0;
+    m3c_size_t hi = document->fragments.len;
+    m3c_size_t mid;
+    M3C_UCP cp;
+    m3c_size_t cpLen;
+
+    pos->line = 0;
+    pos->character = 0;
+    if (hi == 0)
+        return;
+
+    /* NOTE: looking for the last fragment starting at or before `ptr` (the first one always is) */
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if (document->fragments.data[mid].bFirst <= ptr)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    fragment = &document->fragments.data[lo];
 
-    /* NOTE: no free for document buf (`::bFirst`). We don't own it. */
+    pos->line = fragment->pos.line;
+    if (!fragment->bLast)
+        return;
+
+    /* NOTE: only the last fragment can end with EOL and have no fragment after it */
+    if (ptr > fragment->bLast && (*fragment->bLast == '\n' || *fragment->bLast == '\r')) {
+        ++pos->line;
+        return;
+    }
+
+    end = ptr <= fragment->bLast ? ptr : fragment->bLast + 1;
+    for (fragmentPtr = fragment->bFirst; fragmentPtr < end; fragmentPtr += cpLen) {
+        /* NOTE: the lexer moves one character per code point (or invalid sequence) too */
+        M3C_UTF8GetASCIICodepointWithLen(fragmentPtr, fragment->bLast, &cp, &cpLen);
+        ++pos->character;
+    }
 }
 
 M3C_ERROR M3C_ASM_PreProc_New(M3C_ASM_PreProc *preProc) {
@@ -34,7 +111,7 @@ M3C_ERROR M3C_ASM_PreProc_New(M3C_ASM_PreProc *preProc) {
     if (M3C_VEC_NEW_WITH_CAP(M3C_ASM_Document, &preProc->documents, 2) != M3C_ERROR_OK)
         return M3C_ERROR_OOM;
 
-    M3C_VEC_INIT(&preProc->stringPool);
+    __M3C_ASM_StringPool_Init(&preProc->stringPool);
 
     __M3C_ASM_PPSeq_Init(&preProc->seq);
 
@@ -48,115 +125,400 @@ void M3C_ASM_PreProc_Deinit(M3C_ASM_PreProc const *preProc) {
     M3C_VEC_FOREACH(&preProc->documents, &i, &document) { M3C_ASM_Document_Deinit(document); }
     M3C_VEC_DEINIT(&preProc->documents);
 
-    M3C_VEC_DEINIT(&preProc->stringPool);
+    __M3C_ASM_StringPool_Deinit(&preProc->stringPool);
 
     __M3C_ASM_PPSeq_Deinit(&preProc->seq);
 }
 
-M3C_ERROR __M3C_ASM_Document_SplitLines(M3C_ASM_Document *document, m3c_bool usePreproc) {
-    typedef M3C_VEC(M3C_ASM_Fragment) M3C_ASM_Fragments;
+/**
+ * \brief Maximum number of EOL bytes found by one call of #M3C_Scan_FindEOLs in
+ * #__M3C_ASM_LineSplitter_Split.
+ */
+#define __M3C_ASM_SPLIT_LINES_BATCH 256
+
+void __M3C_ASM_LineSplitter_Init(
+    M3C_ASM_LineSplitter *splitter, M3C_ASM_Document const *document, m3c_bool usePreproc
+) {
+    splitter->document = document;
+    splitter->ptr = document->bFirst;
+    splitter->line = 0;
+    splitter->usePreproc = usePreproc;
+}
 
-    M3C_UCP cp;
-    M3C_ASM_Fragments vec;
+m3c_size_t __M3C_ASM_LineSplitter_Split(
+    M3C_ASM_LineSplitter *splitter, M3C_ASM_Fragment *fragments, m3c_size_t maxN
+) {
+    M3C_ASM_Document const *document = splitter->document;
     M3C_ASM_Fragment *fragment;
-    M3C_ASM_Fragment newFragment;
+    m3c_size_t n;
+
+    m3c_u8 const *eols[__M3C_ASM_SPLIT_LINES_BATCH];
+    m3c_size_t eolsMaxN;
+    m3c_size_t eolsLen;
+    m3c_size_t i;
 
     m3c_u8 const *ptr0;
+    m3c_u8 const *scanPtr;
     m3c_u8 const *nextFragmentPtr;
 
-    m3c_size_t cpLen0;
-    m3c_size_t cpLen1;
-    m3c_size_t cpLenB;
+    if (!splitter->ptr || maxN == 0)
+        return 0;
 
-    M3C_ASM_Position pos = {0, 0};
+    /* init first fragment */
+    n = 1;
+    fragment = &fragments[0];
+    fragment->bFirst = splitter->ptr;
+    fragment->bLast = document->bLast;
+    fragment->pos.line = splitter->line;
+    fragment->pos.character = 0;
+
+    /* NOTE: it's the last fragment unless an EOL with some bytes after it is found */
+    splitter->ptr = M3C_NULL;
+
+    /* NOTE: empty document is just one empty fragment */
+    if (!document->bLast)
+        return n;
+
+    /* NOTE: EOL bytes are found in bulk. An invalid encoding never swallows an ASCII byte, so
+     * there is no need to decode the code points between them. Each EOL starts at most one
+     * fragment, so there is no need to find more EOLs than fragments left */
+    scanPtr = fragment->bFirst;
+    do {
+        eolsMaxN = maxN - n + 1 < __M3C_ASM_SPLIT_LINES_BATCH ? maxN - n + 1
+                                                              : __M3C_ASM_SPLIT_LINES_BATCH;
+        eolsLen = M3C_Scan_FindEOLs(scanPtr, document->bLast, eols, eolsMaxN);
+
+        for (i = 0; i < eolsLen; ++i) {
+            ptr0 = eols[i];
+
+            /* NOTE: `\n` of `\r\n` is already a part of the previous fragment */
+            if (ptr0 < fragment->bFirst)
+                continue;
+
+            nextFragmentPtr = ptr0 + 1;
+            if (*ptr0 == '\r' && ptr0 < document->bLast && ptr0[1] == '\n')
+                ++nextFragmentPtr;
+
+            if (splitter->usePreproc && ptr0 > fragment->bFirst && ptr0[-1] == '\\')
+                fragment->bLast = ptr0 - 1 == fragment->bFirst ? M3C_NULL : ptr0 - 2;
+            else
+                fragment->bLast = nextFragmentPtr - 1;
+
+            if (nextFragmentPtr > document->bLast)
+                return n;
+
+            ++splitter->line;
+            if (n == maxN) {
+                splitter->ptr = nextFragmentPtr;
+                return n;
+            }
+
+            fragment = &fragments[n++];
+            fragment->bFirst = nextFragmentPtr;
+            fragment->bLast = document->bLast;
+            fragment->pos.line = splitter->line;
+            fragment->pos.character = 0;
+        }
+
+        if (eolsLen)
+            scanPtr = eols[eolsLen - 1] + 1;
+    } while (eolsLen == eolsMaxN);
+
+    return n;
+}
+
+M3C_ERROR __M3C_ASM_Document_SplitLines(M3C_ASM_Document *document, m3c_bool usePreproc) {
+    typedef M3C_VEC(M3C_ASM_Fragment) M3C_ASM_Fragments;
+
+    M3C_ASM_Fragments vec;
+    M3C_ASM_LineSplitter splitter;
+    m3c_bool isASCII;
 
     if (document->fragments.len)
         return M3C_ERROR_OK;
 
-    vec.data = (M3C_ASM_Fragment *)m3c_malloc(sizeof(M3C_ASM_Fragment) * 2);
-    if (!vec.data)
+    if (M3C_UTF8ValidateBuffer(document->bFirst, document->bLast, &isASCII) != M3C_UTF8_OK)
+        document->encoding = M3C_ASM_DOCUMENT_ENCODING_INVALID;
+    else
+        document->encoding =
+            isASCII ? M3C_ASM_DOCUMENT_ENCODING_ASCII : M3C_ASM_DOCUMENT_ENCODING_UTF8;
+
+    document->usesPreproc = usePreproc;
+
+    /* NOTE: each EOL starts at most one fragment, so the vector is allocated once and never grows.
+     * Growing it would copy the fragments each time (and the bump allocator never frees the old
+     * buffer) */
+    if (M3C_VEC_NEW_WITH_CAP(
+            M3C_ASM_Fragment, &vec,
+            document->bLast ? M3C_Scan_CountEOLs(document->bFirst, document->bLast) + 1 : 1
+        ) != M3C_ERROR_OK)
         return M3C_ERROR_OOM;
-    vec.cap = 2;
-    vec.len = 0;
 
-    /* init first fragment */
-    vec.len = 1;
-    fragment = &vec.data[0];
-    fragment->bFirst = document->bFirst;
-    fragment->bLast = document->bLast;
-    fragment->pos = pos;
+    /* NOTE: there is room for all fragments, so they are split at once */
+    __M3C_ASM_LineSplitter_Init(&splitter, document, usePreproc);
+    vec.len = __M3C_ASM_LineSplitter_Split(&splitter, vec.data, vec.cap);
 
-    ptr0 = document->bFirst;
+    /* fill the fragment cache */
+    document->fragments.data = vec.data;
+    document->fragments.len = vec.len;
 
-    M3C_LOOP {
+    return M3C_ERROR_OK;
+}
 
-        if (M3C_UTF8ReadCodepointWithLen(ptr0, fragment->bLast, &cp, &cpLen0) == M3C_ERROR_EOF)
-            break;
+/**
+ * \brief Initial number of slots in the string pool hash table.
+ */
+#define __M3C_ASM_STRING_POOL_TABLE_START_CAP 1024
+
+void __M3C_ASM_StringPool_Init(M3C_ASM_StringPool *pool) {
+    M3C_VEC_INIT(&pool->strings);
+    pool->table = M3C_NULL;
+    pool->tableCap = 0;
+    pool->tableLen = 0;
+    pool->chunk = M3C_NULL;
+    pool->chunkPtr = M3C_NULL;
+    pool->chunkEnd = M3C_NULL;
+}
 
-        if (cp == '\r') {
+void __M3C_ASM_StringPool_Deinit(M3C_ASM_StringPool const *pool) {
+    M3C_ASM_StringChunk *chunk;
+    M3C_ASM_StringChunk *prevChunk;
+
+    if (pool->strings.data)
+        M3C_VEC_DEINIT(&pool->strings);
+    if (pool->table)
+        m3c_free(pool->table);
+    for (chunk = pool->chunk; chunk; chunk = prevChunk) {
+        prevChunk = chunk->prev;
+        m3c_free(chunk);
+    }
+}
 
-            if (M3C_UTF8ReadCodepointWithLen(ptr0 + cpLen0, fragment->bLast, &cp, &cpLen1) ==
-                    M3C_ERROR_OK &&
-                cp == '\n')
-                nextFragmentPtr = ptr0 + cpLen0 + cpLen1;
-            else
-                nextFragmentPtr = ptr0 + cpLen0;
-
-            if (usePreproc && (M3C_UTF8ReadBackCodepointWithLen(
-                                   ptr0, fragment->bFirst, fragment->bLast, &cp, &cpLenB
-                               ) == M3C_ERROR_OK &&
-                               cp == '\\')) {
-                fragment->bLast = ptr0 - cpLenB == fragment->bFirst ? M3C_NULL : ptr0 - cpLenB - 1;
-            } else
-                fragment->bLast = nextFragmentPtr - 1;
+/**
+ * \brief Calculates the hash of the string (32-bit FNV-1a).
+ */
+m3c_u32 __M3C_ASM_StringPool_hash(m3c_u8 const *str, m3c_u32 len) {
+    m3c_u32 hash = 2166136261U;
+    m3c_u32 i;
 
-            goto cut;
+    for (i = 0; i < len; ++i) {
+        hash ^= str[i];
+        hash *= 16777619U;
+    }
 
-        } else if (cp == '\n') {
+    return hash;
+}
 
-            nextFragmentPtr = ptr0 + cpLen0;
+/**
+ * \brief Doubles the number of slots in the hash table (or allocates the table) and rehashes the
+ * interned strings.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_StringPool_grow(M3C_ASM_StringPool *pool) {
+    m3c_u32 *table;
+    m3c_u32 cap;
+    m3c_u32 mask;
+    m3c_u32 i;
+    m3c_u32 slot;
+
+    if (pool->tableCap == 0)
+        cap = __M3C_ASM_STRING_POOL_TABLE_START_CAP;
+    else if (pool->tableCap >= 0x80000000U ||
+             (m3c_size_t)pool->tableCap * 2 > M3C_SIZE_MAX / sizeof(m3c_u32))
+        return M3C_ERROR_OOM;
+    else
+        cap = pool->tableCap * 2;
+    mask = cap - 1;
 
-            if (usePreproc &&
-                M3C_UTF8ReadBackCodepointWithLen(
-                    ptr0, fragment->bFirst, fragment->bLast, &cp, &cpLenB
-                ) == M3C_ERROR_OK &&
-                cp == '\\') {
-                fragment->bLast = ptr0 - cpLenB == fragment->bFirst ? M3C_NULL : ptr0 - cpLenB - 1;
-            } else {
-                fragment->bLast = nextFragmentPtr - 1;
-            }
+    table = (m3c_u32 *)m3c_malloc(sizeof(m3c_u32) * cap);
+    if (!table)
+        return M3C_ERROR_OOM;
+    m3c_memset(table, 0, sizeof(m3c_u32) * cap);
 
-            goto cut;
-        }
+    for (i = 0; i < pool->tableCap; ++i) {
+        if (pool->table[i] == 0)
+            continue;
 
-        ptr0 += cpLen0;
-        ++pos.character;
-        continue;
+        slot = pool->strings.data[pool->table[i] - 1].hash & mask;
+        while (table[slot])
+            slot = (slot + 1) & mask;
+        table[slot] = pool->table[i];
+    }
 
-    cut:
-        /* NOTE: params - nextFragmentPtr, fragment->bLast */
+    if (pool->table)
+        m3c_free(pool->table);
+    pool->table = table;
+    pool->tableCap = cap;
 
-        if (nextFragmentPtr > document->bLast)
-            break;
+    return M3C_ERROR_OK;
+}
 
-        if (M3C_VEC_PUSH(M3C_ASM_Fragment, &vec, &newFragment) != M3C_ERROR_OK)
-            return M3C_ERROR_OOM;
-        fragment = &vec.data[vec.len - 1];
+m3c_u8 *__M3C_ASM_StringPool_Reserve(M3C_ASM_StringPool *pool, m3c_size_t n) {
+    M3C_ASM_StringChunk *chunk;
+    m3c_size_t size;
+
+    if (pool->chunk && (m3c_size_t)(pool->chunkEnd - pool->chunkPtr) >= n)
+        return pool->chunkPtr;
+
+    /* NOTE: the rest of the current chunk is abandoned */
+    size = n > M3C_ASM_STRING_POOL_CHUNK_SIZE ? n : M3C_ASM_STRING_POOL_CHUNK_SIZE;
+    if (size > M3C_SIZE_MAX - sizeof(M3C_ASM_StringChunk))
+        return M3C_NULL;
 
-        ++pos.line;
-        pos.character = 0;
+    chunk = (M3C_ASM_StringChunk *)m3c_malloc(sizeof(M3C_ASM_StringChunk) + size);
+    if (!chunk)
+        return M3C_NULL;
+    chunk->prev = pool->chunk;
 
-        fragment->bFirst = nextFragmentPtr;
-        fragment->bLast = document->bLast;
-        fragment->pos = pos;
+    pool->chunk = chunk;
+    pool->chunkPtr = (m3c_u8 *)(chunk + 1);
+    pool->chunkEnd = pool->chunkPtr + size;
 
-        ptr0 = nextFragmentPtr;
-        continue;
+    return pool->chunkPtr;
+}
+
+m3c_u8 *__M3C_ASM_StringPool_Extend(M3C_ASM_StringPool *pool, m3c_size_t used, m3c_size_t n) {
+    m3c_u8 const *old = pool->chunkPtr;
+    m3c_u8 *str;
+
+    if (n > M3C_SIZE_MAX - used)
+        return M3C_NULL;
+
+    if (pool->chunk && (m3c_size_t)(pool->chunkEnd - pool->chunkPtr) >= used + n)
+        return pool->chunkPtr;
+
+    /* NOTE: the bytes don't fit, so a new chunk is allocated */
+    str = __M3C_ASM_StringPool_Reserve(pool, used + n);
+    if (str && used)
+        m3c_memcpy(str, old, used);
+
+    return str;
+}
+
+void __M3C_ASM_StringPool_Commit(M3C_ASM_StringPool *pool, m3c_size_t n) { pool->chunkPtr += n; }
+
+/**
+ * \brief Common part of #__M3C_ASM_StringPool_Intern and #__M3C_ASM_StringPool_InternRef.
+ *
+ * \param copy whether to copy a new string into the pool (or just reference it)
+ * \param refs where to record the handle of a new referenced string (or `NULL`)
+ */
+M3C_ERROR __M3C_ASM_StringPool_intern(
+    M3C_ASM_StringPool *pool, m3c_u8 const *str, m3c_u32 len, m3c_bool copy,
+    M3C_ASM_StringRefs *refs, m3c_u32 *hStr
+) {
+    M3C_ASM_CachedString cachedString;
+    M3C_ASM_CachedString const *candidate;
+    m3c_u8 *dst;
+    m3c_u32 hash = __M3C_ASM_StringPool_hash(str, len);
+    m3c_u32 slot;
+    m3c_u32 i;
+
+    /* NOTE: keeping the load factor at most 1/2, so probe sequences are short */
+    if (pool->tableLen >= pool->tableCap / 2 && __M3C_ASM_StringPool_grow(pool) != M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+
+    for (slot = hash & (pool->tableCap - 1); pool->table[slot];
+         slot = (slot + 1) & (pool->tableCap - 1)) {
+        candidate = &pool->strings.data[pool->table[slot] - 1];
+        if (candidate->hash != hash || candidate->len != len)
+            continue;
+
+        for (i = 0; i < len && candidate->ptr[i] == str[i]; ++i)
+            ;
+        if (i == len) {
+            *hStr = pool->table[slot] - 1;
+            return M3C_ERROR_OK;
+        }
     }
 
-    /* fill the fragment cache */
-    document->fragments.data = vec.data;
-    document->fragments.len = vec.len;
+    /* NOTE: `table` keeps `hStr + 1`, so the last handle can't be used */
+    if (pool->strings.len >= 0xFFFFFFFFU)
+        return M3C_ERROR_OOM;
+    /* NOTE: the room is reserved first, so a string is never left unrecorded */
+    if (!copy && refs && M3C_VEC_RESERVE_UNUSED(m3c_u32, refs, 1) != M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+
+    if (copy) {
+        dst = __M3C_ASM_StringPool_Reserve(pool, len);
+        if (!dst)
+            return M3C_ERROR_OOM;
+        if (dst != str)
+            m3c_memcpy(dst, str, len);
+        __M3C_ASM_StringPool_Commit(pool, len);
+
+        cachedString.ptr = dst;
+    } else
+        cachedString.ptr = str;
+    cachedString.len = len;
+    cachedString.hash = hash;
+
+    if (M3C_VEC_PUSH(M3C_ASM_CachedString, &pool->strings, &cachedString) != M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+
+    *hStr = (m3c_u32)(pool->strings.len - 1);
+    pool->table[slot] = *hStr + 1;
+    ++pool->tableLen;
+    if (!copy && refs)
+        refs->data[refs->len++] = *hStr;
 
     return M3C_ERROR_OK;
 }
+
+M3C_ERROR __M3C_ASM_StringPool_Intern(
+    M3C_ASM_StringPool *pool, m3c_u8 const *str, m3c_u32 len, m3c_u32 *hStr
+) {
+    return __M3C_ASM_StringPool_intern(pool, str, len, m3c_true, M3C_NULL, hStr);
+}
+
+M3C_ERROR __M3C_ASM_StringPool_InternRef(
+    M3C_ASM_StringPool *pool, M3C_ASM_StringRefs *refs, m3c_u8 const *str, m3c_u32 len,
+    m3c_u32 *hStr
+) {
+    return __M3C_ASM_StringPool_intern(pool, str, len, m3c_false, refs, hStr);
+}
+
+M3C_ERROR __M3C_ASM_StringPool_Detach(
+    M3C_ASM_StringPool *pool, M3C_ASM_StringRefs *refs, m3c_u8 const *from, m3c_u8 const *to
+) {
+    M3C_ASM_CachedString *string;
+    m3c_u8 *dst;
+    m3c_size_t i = 0;
+
+    while (i < refs->len) {
+        string = &pool->strings.data[refs->data[i]];
+        if (string->ptr + string->len <= from || string->ptr >= to) {
+            ++i;
+            continue;
+        }
+
+        dst = __M3C_ASM_StringPool_Reserve(pool, string->len);
+        if (!dst)
+            return M3C_ERROR_OOM;
+        m3c_memcpy(dst, string->ptr, string->len);
+        __M3C_ASM_StringPool_Commit(pool, string->len);
+
+        string->ptr = dst;
+        /* NOTE: the order of the handles doesn't matter */
+        refs->data[i] = refs->data[--refs->len];
+    }
+
+    return M3C_ERROR_OK;
+}
+
+void __M3C_ASM_StringPool_Move(
+    M3C_ASM_StringPool *pool, M3C_ASM_StringRefs const *refs, m3c_u8 const *from,
+    m3c_u8 const *to, m3c_u8 const *dst
+) {
+    M3C_ASM_CachedString *string;
+    m3c_size_t i;
+
+    for (i = 0; i < refs->len; ++i) {
+        string = &pool->strings.data[refs->data[i]];
+        if (string->ptr >= from && string->ptr + string->len <= to)
+            string->ptr = dst + (string->ptr - from);
+    }
+}
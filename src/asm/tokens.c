@@ -0,0 +1,228 @@
+#include <m3c/asm/tokens.h>
+
+#include <m3c/rt/alloc.h>
+#include <m3c/rt/mem.h>
+
+/**
+ * \brief Initial number of tokens each column can hold.
+ */
+#define __M3C_ASM_TOKENS_START_CAP 64
+
+void __M3C_ASM_Tokens_Init(M3C_ASM_Tokens *tokens) {
+    tokens->kinds = M3C_NULL;
+    tokens->lexemes = M3C_NULL;
+    tokens->offsets = M3C_NULL;
+    tokens->lens = M3C_NULL;
+    M3C_VEC_INIT(&tokens->longLens);
+    tokens->len = 0;
+    tokens->cap = 0;
+}
+
+void __M3C_ASM_Tokens_Deinit(M3C_ASM_Tokens const *tokens) {
+    if (tokens->kinds)
+        m3c_free(tokens->kinds);
+    if (tokens->lexemes)
+        m3c_free(tokens->lexemes);
+    if (tokens->offsets)
+        m3c_free(tokens->offsets);
+    if (tokens->lens)
+        m3c_free(tokens->lens);
+    if (tokens->longLens.data)
+        M3C_VEC_DEINIT(&tokens->longLens);
+}
+
+/**
+ * \brief Reallocates the column so that it can hold `cap` elements of `elemSize` bytes.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_Tokens_growColumn(void **column, m3c_size_t elemSize, m3c_size_t cap) {
+    void *newColumn;
+
+    if (cap > M3C_SIZE_MAX / elemSize)
+        return M3C_ERROR_OOM;
+
+    newColumn = m3c_realloc(*column, cap * elemSize);
+    if (!newColumn)
+        return M3C_ERROR_OOM;
+    *column = newColumn;
+
+    return M3C_ERROR_OK;
+}
+
+/**
+ * \brief Doubles the capacity of the tokens (or allocates the columns).
+ *
+ * \note #M3C_ASM_Tokens::cap is updated only if all columns are reallocated. A column that is
+ * already reallocated just has some unused room.
+ *
+ * \return
+ * + #M3C_ERROR_OK
+ * + #M3C_ERROR_OOM - if the function lacks memory
+ */
+M3C_ERROR __M3C_ASM_Tokens_grow(M3C_ASM_Tokens *tokens) {
+    m3c_size_t cap;
+
+    if (tokens->cap == 0)
+        cap = __M3C_ASM_TOKENS_START_CAP;
+    else if (tokens->cap > M3C_SIZE_MAX / 2)
+        return M3C_ERROR_OOM;
+    else
+        cap = tokens->cap * 2;
+
+    if (__M3C_ASM_Tokens_growColumn((void **)&tokens->kinds, sizeof(m3c_u8), cap) !=
+            M3C_ERROR_OK ||
+        __M3C_ASM_Tokens_growColumn((void **)&tokens->lexemes, sizeof(M3C_ASM_Lexeme), cap) !=
+            M3C_ERROR_OK ||
+        __M3C_ASM_Tokens_growColumn((void **)&tokens->offsets, sizeof(m3c_u32), cap) !=
+            M3C_ERROR_OK ||
+        __M3C_ASM_Tokens_growColumn((void **)&tokens->lens, sizeof(m3c_u16), cap) != M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+    tokens->cap = cap;
+
+    return M3C_ERROR_OK;
+}
+
+M3C_ERROR __M3C_ASM_Tokens_Push(M3C_ASM_Tokens *tokens, M3C_ASM_Token const *token) {
+    M3C_ASM_TokenLongLen longLen;
+
+    if (tokens->len == tokens->cap && __M3C_ASM_Tokens_grow(tokens) != M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+
+    if (token->len >= M3C_ASM_TOKENS_LONG_LEN) {
+        longLen.hToken = (M3C_ASM_hToken)tokens->len;
+        longLen.len = token->len;
+        if (M3C_VEC_PUSH(M3C_ASM_TokenLongLen, &tokens->longLens, &longLen) != M3C_ERROR_OK)
+            return M3C_ERROR_OOM;
+        tokens->lens[tokens->len] = M3C_ASM_TOKENS_LONG_LEN;
+    } else
+        tokens->lens[tokens->len] = (m3c_u16)token->len;
+
+    tokens->kinds[tokens->len] = (m3c_u8)token->kind;
+    tokens->lexemes[tokens->len] = token->lexeme;
+    tokens->offsets[tokens->len] = token->offset;
+    ++tokens->len;
+
+    return M3C_ERROR_OK;
+}
+
+/**
+ * \brief Replaces `n` elements of the column starting at `first` with `srcN` elements of `src`.
+ *
+ * \warning The column must have room for all elements.
+ */
+void __M3C_ASM_Tokens_spliceColumn(
+    void *column, m3c_size_t elemSize, m3c_size_t len, m3c_size_t first, m3c_size_t n,
+    void const *src, m3c_size_t srcN
+) {
+    m3c_u8 *bytes = (m3c_u8 *)column;
+
+    /* NOTE: an empty column may be `NULL` */
+    if (len > first + n && n != srcN)
+        m3c_memmove(
+            bytes + (first + srcN) * elemSize, bytes + (first + n) * elemSize,
+            (len - first - n) * elemSize
+        );
+    if (srcN)
+        m3c_memcpy(bytes + first * elemSize, src, srcN * elemSize);
+}
+
+/**
+ * \brief Returns the index of the first long length of the token with the handle not less than
+ * `hToken`.
+ */
+m3c_size_t __M3C_ASM_Tokens_lowerLongLen(M3C_ASM_Tokens const *tokens, m3c_size_t hToken) {
+    m3c_size_t lo = 0;
+    m3c_size_t hi = tokens->longLens.len;
+    m3c_size_t mid;
+
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (tokens->longLens.data[mid].hToken < hToken)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+M3C_ERROR __M3C_ASM_Tokens_Splice(
+    M3C_ASM_Tokens *tokens, m3c_size_t first, m3c_size_t last, M3C_ASM_Tokens const *src,
+    m3c_u32 delta
+) {
+    m3c_size_t newLen = tokens->len - (last - first) + src->len;
+    m3c_size_t longFirst;
+    m3c_size_t longLast;
+    m3c_size_t i;
+
+    /* NOTE: all memory is allocated before the tokens are changed, so they are intact on failure */
+    while (tokens->cap < newLen) {
+        if (__M3C_ASM_Tokens_grow(tokens) != M3C_ERROR_OK)
+            return M3C_ERROR_OOM;
+    }
+    if (M3C_VEC_RESERVE_UNUSED(M3C_ASM_TokenLongLen, &tokens->longLens, src->longLens.len) !=
+        M3C_ERROR_OK)
+        return M3C_ERROR_OOM;
+
+    __M3C_ASM_Tokens_spliceColumn(
+        tokens->kinds, sizeof(m3c_u8), tokens->len, first, last - first, src->kinds, src->len
+    );
+    __M3C_ASM_Tokens_spliceColumn(
+        tokens->lexemes, sizeof(M3C_ASM_Lexeme), tokens->len, first, last - first, src->lexemes,
+        src->len
+    );
+    __M3C_ASM_Tokens_spliceColumn(
+        tokens->offsets, sizeof(m3c_u32), tokens->len, first, last - first, src->offsets, src->len
+    );
+    __M3C_ASM_Tokens_spliceColumn(
+        tokens->lens, sizeof(m3c_u16), tokens->len, first, last - first, src->lens, src->len
+    );
+
+    /* NOTE: offsets and handles are `u32`, so adding a "negative" delta just wraps around */
+    for (i = first + src->len; i < newLen; ++i)
+        tokens->offsets[i] += delta;
+
+    longFirst = __M3C_ASM_Tokens_lowerLongLen(tokens, first);
+    longLast = __M3C_ASM_Tokens_lowerLongLen(tokens, last);
+    __M3C_ASM_Tokens_spliceColumn(
+        tokens->longLens.data, sizeof(M3C_ASM_TokenLongLen), tokens->longLens.len, longFirst,
+        longLast - longFirst, src->longLens.data, src->longLens.len
+    );
+    tokens->longLens.len = tokens->longLens.len - (longLast - longFirst) + src->longLens.len;
+
+    for (i = longFirst; i < longFirst + src->longLens.len; ++i)
+        tokens->longLens.data[i].hToken += (M3C_ASM_hToken)first;
+    for (; i < tokens->longLens.len; ++i)
+        tokens->longLens.data[i].hToken += (M3C_ASM_hToken)(newLen - tokens->len);
+
+    tokens->len = newLen;
+
+    return M3C_ERROR_OK;
+}
+
+m3c_u32 __M3C_ASM_Tokens_LongLen(M3C_ASM_Tokens const *tokens, M3C_ASM_hToken hToken) {
+    m3c_size_t lo = 0;
+    m3c_size_t hi = tokens->longLens.len;
+    m3c_size_t mid;
+
+    /* NOTE: the token must be there, so the search always finds it */
+    while (hi - lo > 1) {
+        mid = lo + (hi - lo) / 2;
+        if (tokens->longLens.data[mid].hToken <= hToken)
+            lo = mid;
+        else
+            hi = mid;
+    }
+
+    return tokens->longLens.data[lo].len;
+}
+
+void M3C_ASM_Tokens_Get(M3C_ASM_Tokens const *tokens, M3C_ASM_hToken hToken, M3C_ASM_Token *token) {
+    token->lexeme = M3C_ASM_TOKENS_LEXEME(tokens, hToken);
+    token->kind = M3C_ASM_TOKENS_KIND(tokens, hToken);
+    token->offset = M3C_ASM_TOKENS_OFFSET(tokens, hToken);
+    token->len = M3C_ASM_TOKENS_LEN(tokens, hToken);
+}
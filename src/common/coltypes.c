@@ -37,6 +37,9 @@ M3C_ERROR M3C_VEC_ReserveUnused_impl(
         return M3C_ERROR_OOM;
     minCap = n + *len;
 
+    if (*cap >= minCap)
+        return M3C_ERROR_OK;
+
     /* NOTE: avoiding overflow of `*cap + *cap`. Arithmetically it's equivalent to
      * `min(M3C_SIZE_MAX, *cap + *cap)` */
     doubledCap = *cap > M3C_SIZE_MAX - *cap ? M3C_SIZE_MAX : *cap + *cap;
@@ -2,6 +2,8 @@
 
 #include <m3c/common/macros.h>
 
+#include <m3c/rt/x86-64/utf8.h>
+
 typedef struct __tagM3C_ByteRange {
     m3c_u8 lo;
     m3c_u8 hi;
@@ -128,7 +130,7 @@ M3C_ERROR M3C_UTF8GetASCIICodepointWithLen(
     ++ptr; /* now *ptr is pointing to the second byte */
     ++(*len);
 
-    if (last - *ptr >= 0) {
+    if (last - ptr >= 0) {
 
         /* checking the second byte */
         if (!M3C_InRange(*ptr, secondByte->lo, secondByte->hi))
@@ -306,3 +308,41 @@ M3C_UTF8WriteCodepointWithLen(m3c_u8 *ptr, const m3c_u8 *last, M3C_UCP cp, m3c_s
     } else
         return M3C_ERROR_INVALID_ENCODING;
 }
+
+/**
+ * \brief Byte-at-a-time version of #M3C_UTF8ValidateBuffer.
+ */
+int __M3C_UTF8ValidateBuffer_Byte(const m3c_u8 *ptr, const m3c_u8 *last, m3c_bool *isASCII) {
+    m3c_bool ascii = m3c_true;
+
+    while (ptr <= last) {
+        if (*ptr >= 0x80)
+            ascii = m3c_false;
+
+        if (M3C_UTF8ValidateCodepoint(&ptr, last) != M3C_UTF8_OK)
+            return M3C_UTF8_ERR;
+    }
+
+    *isASCII = ascii;
+    return M3C_UTF8_OK;
+}
+
+typedef int (*__M3C_UTF8ValidateFn)(const m3c_u8 *ptr, const m3c_u8 *last, m3c_bool *isASCII);
+
+#ifdef M3C_X86_64_SIMD
+/* NOTE: SSE2 is a part of x86-64, so it's safe to use it without detection */
+static __M3C_UTF8ValidateFn __m3c_utf8_validate_buffer = __M3C_UTF8ValidateBuffer_SSE2;
+#else
+static __M3C_UTF8ValidateFn __m3c_utf8_validate_buffer = __M3C_UTF8ValidateBuffer_Byte;
+#endif
+
+void M3C_UTF8_Init(void) {
+#ifdef M3C_X86_64_SIMD
+    if (M3C_CPU_DetectFeatures() & M3C_CPU_FEATURE_AVX2)
+        __m3c_utf8_validate_buffer = __M3C_UTF8ValidateBuffer_AVX2;
+#endif
+}
+
+int M3C_UTF8ValidateBuffer(const m3c_u8 *ptr, const m3c_u8 *last, m3c_bool *isASCII) {
+    return __m3c_utf8_validate_buffer(ptr, last, isASCII);
+}
@@ -1,7 +1,424 @@
 #include <m3c/rt/main.h>
 
+#include <m3c/common/macros.h>
+#include <m3c/common/utf8.h>
+#include <m3c/rt/file.h>
+#include <m3c/rt/mem.h>
+#include <m3c/rt/runtime.h>
+#include <m3c/rt/scan.h>
+#include <m3c/rt/syscalls.h>
+
+#include <m3c/asm/preproc.h>
+#include <m3c/asm/lex.h>
+#include <m3c/asm/plex.h>
+
+/**
+ * \brief Usage message.
+ */
+#define __M3C_DRIVER_USAGE                                                                         \
+    "usage: m3c [--jobs N] [--batch MANIFEST]... [FILE]...\n"                                      \
+    "\n"                                                                                           \
+    "Lexes each FILE and prints diagnostics to stderr.\n"                                          \
+    "\n"                                                                                           \
+    "  --jobs N          lex each large file by N threads (applies to the files after it)\n"     \
+    "  --batch MANIFEST  lex every file listed in MANIFEST (one path per line, empty lines\n"      \
+    "                    and lines starting with '#' are skipped)\n"
+
+/**
+ * \brief Size of the output buffer.
+ */
+#define __M3C_DRIVER_OUT_BUF_SIZE 65536
+
+/**
+ * \brief Maximum length of a path in the manifest.
+ */
+#define __M3C_DRIVER_MAX_PATH 4096
+
+/**
+ * \brief Exit codes.
+ */
+typedef enum __tagM3C_DriverExitCode {
+    /**
+     * \brief All files are lexed without errors.
+     */
+    M3C_DRIVER_EXIT_OK = 0,
+    /**
+     * \brief Some files have error diagnostics.
+     */
+    M3C_DRIVER_EXIT_DIAGNOSTICS = 1,
+    /**
+     * \brief Some files can't be read (or the driver is out of memory).
+     */
+    M3C_DRIVER_EXIT_FAILURE = 2,
+    /**
+     * \brief Bad command line.
+     */
+    M3C_DRIVER_EXIT_USAGE = 3
+} M3C_DriverExitCode;
+
+/**
+ * \brief Buffered output to `stderr`.
+ *
+ * \note Diagnostics of thousands of files are written by big chunks, not by a syscall per line.
+ */
+typedef struct __tagM3C_DriverOut {
+    /**
+     * \brief Number of used bytes in #buf.
+     */
+    m3c_size_t len;
+    /**
+     * \brief Buffer.
+     */
+    char buf[__M3C_DRIVER_OUT_BUF_SIZE];
+} M3C_DriverOut;
+
+static M3C_DriverOut __m3c_out;
+
+/**
+ * \brief Maximum number of threads lexing one file (see #M3C_ASM_lexParallel).
+ */
+static m3c_size_t __m3c_jobs = 1;
+
+/**
+ * \brief Writes the buffered output.
+ */
+void __M3C_Driver_Flush(void) {
+    char const *ptr = __m3c_out.buf;
+    long res;
+
+    while (__m3c_out.len) {
+        res = m3c_syscall_write(2, ptr, (long)__m3c_out.len);
+        if (M3C_IsRawErrno(res))
+            break;
+
+        ptr += res;
+        __m3c_out.len -= (m3c_size_t)res;
+    }
+
+    __m3c_out.len = 0;
+}
+
+/**
+ * \brief Appends `len` bytes to the output.
+ */
+void __M3C_Driver_PutBytes(char const *bytes, m3c_size_t len) {
+    while (len) {
+        if (__m3c_out.len == __M3C_DRIVER_OUT_BUF_SIZE)
+            __M3C_Driver_Flush();
+
+        __m3c_out.buf[__m3c_out.len++] = *bytes++;
+        --len;
+    }
+}
+
+/**
+ * \brief Appends the null-terminated string to the output.
+ */
+void __M3C_Driver_PutStr(char const *str) {
+    m3c_size_t len = 0;
+
+    while (str[len])
+        ++len;
+
+    __M3C_Driver_PutBytes(str, len);
+}
+
+/**
+ * \brief Appends the decimal number to the output.
+ */
+void __M3C_Driver_PutNum(m3c_u32 num) {
+    char digits[10];
+    int len = 0;
+
+    do {
+        digits[len++] = (char)('0' + num % 10);
+        num /= 10;
+    } while (num);
+
+    while (len)
+        __M3C_Driver_PutBytes(&digits[--len], 1);
+}
+
+/**
+ * \brief Returns the name of the severity.
+ */
+char const *__M3C_Driver_SeverityName(M3C_Severity severity) {
+    switch (severity) {
+    case M3C_SEVERITY_NOTE:
+        return "note";
+    case M3C_SEVERITY_WARNING:
+        return "warning";
+    case M3C_SEVERITY_ERROR:
+        return "error";
+    default:
+        return "fatal error";
+    }
+}
+
+/**
+ * \brief Prints the diagnostic in the `path:line:col: severity: message` format.
+ *
+ * \details The line and the column are computed from the diagnostic offset only here (see
+ * #M3C_ASM_Document_GetPosition).
+ */
+void __M3C_Driver_PrintDiagnostic(
+    char const *path, M3C_ASM_Document const *document, M3C_Diagnostic const *diagnostic
+) {
+    M3C_FmtArgs const *args = &diagnostic->info->args;
+    M3C_ASM_Position pos;
+    m3c_u8 i;
+
+    M3C_ASM_Document_GetPosition(document, diagnostic->data.ASM.start, &pos);
+
+    __M3C_Driver_PutStr(path);
+    __M3C_Driver_PutBytes(":", 1);
+    __M3C_Driver_PutNum(pos.line + 1);
+    __M3C_Driver_PutBytes(":", 1);
+    __M3C_Driver_PutNum(pos.character + 1);
+    __M3C_Driver_PutStr(": ");
+    __M3C_Driver_PutStr(__M3C_Driver_SeverityName(diagnostic->severity));
+    __M3C_Driver_PutStr(":");
+
+    for (i = 0; i < args->len; ++i) {
+        /* NOTE: the first byte of LU8_ASCII is the length of the string */
+        __M3C_Driver_PutBytes(" ", 1);
+        __M3C_Driver_PutBytes(
+            (char const *)args->data[i].val.LU8_ASCII + 1, args->data[i].val.LU8_ASCII[0]
+        );
+    }
+
+    __M3C_Driver_PutBytes("\n", 1);
+}
+
+/**
+ * \brief Lexes the file and prints its diagnostics.
+ *
+ * \details All memory allocated for the file is freed before return: the heap claimed by the
+ * calling thread is returned when the scope of the file is left and the arenas of the lexing
+ * threads when they are joined (see #M3C_Runtime_LeaveScope and #M3C_Runtime_JoinThread). So the
+ * batch of files runs in the memory of the biggest one.
+ *
+ * \param[in] path path to the file (null-terminated)
+ *
+ * \return exit code for this file
+ */
+M3C_DriverExitCode __M3C_Driver_ProcessFile(char const *path) {
+    M3C_DriverExitCode res = M3C_DRIVER_EXIT_OK;
+    M3C_ASM_PreProc preProc;
+    M3C_ASM_Document document;
+    M3C_ASM_Document *pDocument;
+    M3C_Diagnostic const *diagnostic;
+    m3c_size_t i;
+    M3C_ERROR status;
+#ifdef M3C_FEATURE_API_SYSCALLS
+    M3C_RuntimeScope scope;
+
+    M3C_Runtime_EnterScope(&scope);
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+    if (M3C_ASM_PreProc_New(&preProc) != M3C_ERROR_OK) {
+        res = M3C_DRIVER_EXIT_FAILURE;
+        goto out;
+    }
+
+    if (M3C_ASM_Document_InitFromFile(&document, path) != M3C_ERROR_OK) {
+        __M3C_Driver_PutStr("m3c: error: can't read '");
+        __M3C_Driver_PutStr(path);
+        __M3C_Driver_PutStr("'\n");
+
+        res = M3C_DRIVER_EXIT_FAILURE;
+        goto deinit;
+    }
+
+    if (M3C_VEC_PUSH(M3C_ASM_Document, &preProc.documents, &document) != M3C_ERROR_OK) {
+        M3C_ASM_Document_Deinit(&document);
+
+        res = M3C_DRIVER_EXIT_FAILURE;
+        goto deinit;
+    }
+    pDocument = &preProc.documents.data[0];
+
+    status = __M3C_ASM_Document_SplitLines(pDocument, m3c_true);
+    if (status == M3C_ERROR_OK)
+        status = M3C_ASM_lexParallel(&preProc, 0, __m3c_jobs);
+    if (status != M3C_ERROR_OK) {
+        __M3C_Driver_PutStr(
+            status == M3C_ERROR_OOB ? "m3c: error: file is too large: '"
+                                    : "m3c: error: out of memory while lexing '"
+        );
+        __M3C_Driver_PutStr(path);
+        __M3C_Driver_PutStr("'\n");
+
+        res = M3C_DRIVER_EXIT_FAILURE;
+        goto deinit;
+    }
+
+    M3C_VEC_FOREACH(&pDocument->diagnostics.vec, &i, &diagnostic) {
+        __M3C_Driver_PrintDiagnostic(path, pDocument, diagnostic);
+    }
+
+    if (pDocument->diagnostics.errors)
+        res = M3C_DRIVER_EXIT_DIAGNOSTICS;
+
+deinit:
+    M3C_ASM_PreProc_Deinit(&preProc);
+
+out:
+#ifdef M3C_FEATURE_API_SYSCALLS
+    M3C_Runtime_LeaveScope(&scope);
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+    return res;
+}
+
+/**
+ * \brief Lexes every file listed in the manifest.
+ *
+ * \param[in] path path to the manifest (null-terminated)
+ *
+ * \return the worst exit code of the files
+ */
+M3C_DriverExitCode __M3C_Driver_ProcessManifest(char const *path) {
+    M3C_DriverExitCode res = M3C_DRIVER_EXIT_OK;
+    M3C_DriverExitCode fileRes;
+    M3C_FileMapping manifest;
+    m3c_u8 const *ptr;
+    m3c_u8 const *end;
+    m3c_u8 const *eol;
+    m3c_size_t len;
+    char filePath[__M3C_DRIVER_MAX_PATH];
+
+    if (M3C_File_Map(path, &manifest) != M3C_ERROR_OK) {
+        __M3C_Driver_PutStr("m3c: error: can't read manifest '");
+        __M3C_Driver_PutStr(path);
+        __M3C_Driver_PutStr("'\n");
+
+        return M3C_DRIVER_EXIT_FAILURE;
+    }
+
+    ptr = manifest.ptr;
+    end = manifest.ptr + manifest.len;
+
+    for (; ptr < end; ptr = eol + 1) {
+        for (eol = ptr; eol < end && *eol != '\n'; ++eol)
+            ;
+
+        len = (m3c_size_t)(eol - ptr);
+        if (len && ptr[len - 1] == '\r')
+            --len;
+
+        if (!len || *ptr == '#')
+            continue;
+
+        if (len >= __M3C_DRIVER_MAX_PATH) {
+            __M3C_Driver_PutStr("m3c: error: path in manifest '");
+            __M3C_Driver_PutStr(path);
+            __M3C_Driver_PutStr("' is too long\n");
+
+            res = M3C_DRIVER_EXIT_FAILURE;
+            continue;
+        }
+
+        m3c_memcpy(filePath, ptr, len);
+        filePath[len] = '\0';
+
+        fileRes = __M3C_Driver_ProcessFile(filePath);
+        if (fileRes > res)
+            res = fileRes;
+    }
+
+    M3C_File_Unmap(&manifest);
+
+    return res;
+}
+
+/**
+ * \brief Compares two null-terminated strings for equality.
+ */
+m3c_bool __M3C_Driver_StrEq(char const *a, char const *b) {
+    while (*a && *a == *b) {
+        ++a;
+        ++b;
+    }
+
+    return *a == *b;
+}
+
+/**
+ * \brief Parses the positive decimal number.
+ *
+ * \return whether the string is such a number
+ */
+m3c_bool __M3C_Driver_ParseNum(char const *str, m3c_size_t *num) {
+    *num = 0;
+
+    do {
+        if (*str < '0' || *str > '9' || *num > (M3C_SIZE_MAX - 9) / 10)
+            return m3c_false;
+        *num = *num * 10 + (m3c_size_t)(*str - '0');
+    } while (*++str);
+
+    return *num != 0;
+}
+
 /**
  * \warning Not a stdlib `main` function. When the result is returned, the process is immediately
  * terminated (e.g. no `atexit` functions called).
  */
-int main(int argc, char *argv[]) { return 0; }
+int main(int argc, char *argv[]) {
+    M3C_DriverExitCode res = M3C_DRIVER_EXIT_OK;
+    M3C_DriverExitCode fileRes;
+    int i;
+
+    if (argc < 2) {
+        __M3C_Driver_PutStr(__M3C_DRIVER_USAGE);
+        __M3C_Driver_Flush();
+
+        return M3C_DRIVER_EXIT_USAGE;
+    }
+
+#ifdef M3C_FEATURE_API_SYSCALLS
+    if (M3C_Runtime_New()) {
+        __M3C_Driver_PutStr("m3c: fatal error: can't init runtime\n");
+        __M3C_Driver_Flush();
+
+        return M3C_DRIVER_EXIT_FAILURE;
+    }
+#else
+    M3C_Mem_Init();
+    M3C_Scan_Init();
+    M3C_UTF8_Init();
+#endif /* M3C_FEATURE_API_SYSCALLS */
+
+    for (i = 1; i < argc; ++i) {
+        if (__M3C_Driver_StrEq(argv[i], "--jobs")) {
+            if (++i == argc || !__M3C_Driver_ParseNum(argv[i], &__m3c_jobs)) {
+                __M3C_Driver_PutStr(__M3C_DRIVER_USAGE);
+                __M3C_Driver_Flush();
+
+                return M3C_DRIVER_EXIT_USAGE;
+            }
+
+            continue;
+        }
+
+        if (__M3C_Driver_StrEq(argv[i], "--batch")) {
+            if (++i == argc) {
+                __M3C_Driver_PutStr(__M3C_DRIVER_USAGE);
+                __M3C_Driver_Flush();
+
+                return M3C_DRIVER_EXIT_USAGE;
+            }
+
+            fileRes = __M3C_Driver_ProcessManifest(argv[i]);
+        } else
+            fileRes = __M3C_Driver_ProcessFile(argv[i]);
+
+        if (fileRes > res)
+            res = fileRes;
+    }
+
+    __M3C_Driver_Flush();
+
+    return res;
+}
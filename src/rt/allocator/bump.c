@@ -6,6 +6,11 @@ void M3C_BumpAllocator_New(M3C_BumpAllocator *ba, void *first, void *last) {
     ba->first = first;
     ba->ptr = first;
     ba->last = last;
+    ba->top = M3C_NULL;
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+    m3c_memset(&ba->stats, 0, sizeof(ba->stats));
+#endif /* M3C_FEATURE_ALLOC_STATS */
 }
 
 /**
@@ -34,6 +39,7 @@ void *__M3C_BumpAllocator_TryAllocFrom(M3C_BumpAllocator *ba, void *ptr, m3c_siz
 
     res = ptr;
     ba->ptr = (char *)ptr + size;
+    ba->top = res;
     return res;
 }
 
@@ -56,6 +62,11 @@ void *M3C_BumpAllocator_AllocAligned(M3C_BumpAllocator *ba, m3c_size_t alignment
         alignedPtr = (char *)ba->ptr + coremainder;
     }
 
+#ifdef M3C_FEATURE_ALLOC_STATS
+    if (alignedPtr != ba->ptr && (m3c_size_t)((char *)ba->last - (char *)alignedPtr) >= size)
+        ba->stats.paddingBytes += (char *)alignedPtr - (char *)ba->ptr;
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
     return __M3C_BumpAllocator_TryAllocFrom(ba, alignedPtr, size);
 }
 
@@ -85,6 +96,19 @@ void *M3C_BumpAllocator_ReallocAligned(
     void *res;
     m3c_size_t old_size_max;
 
+    /* NOTE: the last allocated object ends at the bump pointer, so we can just move the pointer */
+    if (ptr && ptr == ba->top && (m3c_size_t)ptr % alignment == 0) {
+        /* NOTE: `ptr` is before the bump pointer, so it's `ba->first <= ptr <= ba->last` */
+        res = __M3C_BumpAllocator_TryAllocFrom(ba, ptr, new_size);
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+        if (res)
+            ++ba->stats.inPlaceReallocs;
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+        return res;
+    }
+
     /* NOTE: as we don't know old size of the object so we simply allocate the new one and copy */
     res = M3C_BumpAllocator_AllocAligned(ba, alignment, new_size);
 
@@ -97,7 +121,45 @@ void *M3C_BumpAllocator_ReallocAligned(
         /* NOTE: we using `min()` here to ensure that the regions will not overlap and we don't
          * touch memory after the allocator buffer */
         m3c_memcpy(res, ptr, m3c_min(old_size_max, new_size));
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+        ++ba->stats.copyingReallocs;
+        ba->stats.copiedBytes += m3c_min(old_size_max, new_size);
+#endif /* M3C_FEATURE_ALLOC_STATS */
     }
 
     return res;
 }
+
+void M3C_BumpAllocator_FreeSized(M3C_BumpAllocator *ba, void *ptr, m3c_size_t size) {
+    /* NOTE: only the last object ends exactly at the bump pointer */
+    if (!ptr || (char *)ptr + size != (char *)ba->ptr)
+        return;
+
+    ba->ptr = ptr;
+    /* NOTE: we don't know where the previous object starts */
+    ba->top = M3C_NULL;
+}
+
+M3C_BumpAllocatorMark M3C_BumpAllocator_Mark(M3C_BumpAllocator *ba) {
+    M3C_BumpAllocatorMark mark;
+
+    mark.first = ba->first;
+    mark.ptr = ba->ptr;
+    mark.last = ba->last;
+
+    /* NOTE: the top object is before the checkpoint, so it must not grow over it */
+    ba->top = M3C_NULL;
+
+    return mark;
+}
+
+void M3C_BumpAllocator_Release(M3C_BumpAllocator *ba, M3C_BumpAllocatorMark mark) {
+    /* NOTE: the bump pointer may be rolled back before the checkpoint by `FreeSized` */
+    if (ba->first != mark.first || (char *)mark.ptr < (char *)ba->ptr)
+        ba->ptr = mark.ptr;
+
+    ba->first = mark.first;
+    ba->last = mark.last;
+    ba->top = M3C_NULL;
+}
@@ -0,0 +1,293 @@
+#include <m3c/rt/allocator/segregated.h>
+
+#include <m3c/common/macros.h>
+#include <m3c/rt/mem.h>
+
+#ifdef M3C_FUNDAMENTAL_ALIGN
+
+/**
+ * \brief Returns a pointer to the capacity stored in the header of the object.
+ */
+#    define __M3C_SEGREGATED_CAP(ptr)                                                              \
+        (*(m3c_size_t *)((char *)(ptr) - M3C_SEGREGATED_HEADER_SIZE))
+
+/**
+ * \brief Returns the link to the next free object stored in the free object `ptr`.
+ */
+#    define __M3C_SEGREGATED_NEXT(ptr) (*(void **)(ptr))
+
+void M3C_SegregatedAllocator_New(
+    M3C_SegregatedAllocator *sa, M3C_BumpAllocator *backing, M3C_PageAllocCB largeAlloc,
+    M3C_PageFreeCB largeFree
+) {
+    int i;
+
+    sa->backing = backing;
+    sa->largeAlloc = largeAlloc;
+    sa->largeFree = largeFree;
+
+    for (i = 0; i < M3C_SEGREGATED_CLASSES; ++i)
+        sa->freeLists[i] = M3C_NULL;
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    m3c_memset(&sa->stats, 0, sizeof(sa->stats));
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+}
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+/**
+ * \brief Accounts `delta` bytes of live objects (and updates the high-water mark).
+ */
+#        define __M3C_SEGREGATED_STATS_LIVE(sa, delta)                                             \
+            do {                                                                                   \
+                (sa)->stats.liveBytes += (delta);                                                  \
+                if ((sa)->stats.liveBytes > (sa)->stats.peakLiveBytes)                             \
+                    (sa)->stats.peakLiveBytes = (sa)->stats.liveBytes;                             \
+            } while (0)
+
+/**
+ * \brief Accounts the allocation of `size` bytes.
+ */
+void __M3C_SegregatedAllocator_CountAlloc(M3C_SegregatedAllocator *sa, m3c_size_t size) {
+    int bucket = 0;
+
+    ++sa->stats.allocs;
+    sa->stats.allocatedBytes += size;
+
+    for (; bucket < M3C_SEGREGATED_STATS_BUCKETS - 1 && ((m3c_size_t)1 << bucket) < size; ++bucket)
+        ;
+    ++sa->stats.histogram[bucket];
+}
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+/**
+ * \brief Finds the smallest size class that can hold `size` bytes.
+ *
+ * \warning `size` must not be greater than #M3C_SEGREGATED_MAX_CLASS_SIZE.
+ *
+ * \param size object size in bytes
+ * \return size class index
+ */
+int __M3C_SegregatedAllocator_ClassOf(m3c_size_t size) {
+    int cls = 0;
+    m3c_size_t cap = M3C_SEGREGATED_MIN_CLASS_SIZE;
+
+    while (cap < size) {
+        cap <<= 1;
+        ++cls;
+    }
+
+    return cls;
+}
+
+/**
+ * \brief Allocates a large object.
+ *
+ * \param[in,out] sa   segregated-fit allocator
+ * \param         size object size in bytes. Must be greater than #M3C_SEGREGATED_MAX_CLASS_SIZE
+ *
+ * \return
+ * + on failure - `NULL`
+ * + on success - pointer to the object
+ */
+void *__M3C_SegregatedAllocator_AllocLarge(M3C_SegregatedAllocator *sa, m3c_size_t size) {
+    char *block;
+
+    if (!sa->largeAlloc || size > M3C_SIZE_MAX - M3C_SEGREGATED_HEADER_SIZE)
+        return M3C_NULL;
+
+    block = sa->largeAlloc(size + M3C_SEGREGATED_HEADER_SIZE);
+    if (!block)
+        return M3C_NULL;
+
+    block += M3C_SEGREGATED_HEADER_SIZE;
+    __M3C_SEGREGATED_CAP(block) = size;
+
+    return block;
+}
+
+/**
+ * \brief Allocates the object (without accounting it in statistics).
+ *
+ * \param[in,out] sa   segregated-fit allocator
+ * \param         size object size in bytes
+ *
+ * \return
+ * + on failure - `NULL`
+ * + on success - pointer to the object
+ */
+void *__M3C_SegregatedAllocator_AllocObject(M3C_SegregatedAllocator *sa, m3c_size_t size) {
+    int cls;
+    m3c_size_t cap;
+    char *block;
+
+    if (size > M3C_SEGREGATED_MAX_CLASS_SIZE)
+        return __M3C_SegregatedAllocator_AllocLarge(sa, size);
+
+    cls = __M3C_SegregatedAllocator_ClassOf(size);
+
+    /* reuse the freed object of this size class (if any) */
+    block = sa->freeLists[cls];
+    if (block) {
+        sa->freeLists[cls] = __M3C_SEGREGATED_NEXT(block);
+        return block;
+    }
+
+    /* NOTE: every size class is a multiple of the header size, so the bump pointer stays aligned
+     * and the header is placed right before the object without any padding */
+    cap = (m3c_size_t)M3C_SEGREGATED_MIN_CLASS_SIZE << cls;
+    block = M3C_BumpAllocator_AllocAligned(
+        sa->backing, M3C_FUNDAMENTAL_ALIGN, cap + M3C_SEGREGATED_HEADER_SIZE
+    );
+    if (!block)
+        return M3C_NULL;
+
+    block += M3C_SEGREGATED_HEADER_SIZE;
+    __M3C_SEGREGATED_CAP(block) = cap;
+
+    return block;
+}
+
+void *M3C_SegregatedAllocator_Alloc(M3C_SegregatedAllocator *sa, m3c_size_t size) {
+    void *res = __M3C_SegregatedAllocator_AllocObject(sa, size);
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    if (res) {
+        __M3C_SegregatedAllocator_CountAlloc(sa, size);
+        __M3C_SEGREGATED_STATS_LIVE(sa, __M3C_SEGREGATED_CAP(res) + M3C_SEGREGATED_HEADER_SIZE);
+    }
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+    return res;
+}
+
+/**
+ * \brief Frees the object (without accounting it in statistics).
+ *
+ * \param[in,out] sa  segregated-fit allocator
+ * \param         ptr pointer to the object. Must not be `NULL`
+ */
+void __M3C_SegregatedAllocator_FreeObject(M3C_SegregatedAllocator *sa, void *ptr) {
+    int cls;
+    char *block;
+    m3c_size_t cap;
+
+    cap = __M3C_SEGREGATED_CAP(ptr);
+    block = (char *)ptr - M3C_SEGREGATED_HEADER_SIZE;
+
+    if (cap > M3C_SEGREGATED_MAX_CLASS_SIZE) {
+        sa->largeFree(block, cap + M3C_SEGREGATED_HEADER_SIZE);
+        return;
+    }
+
+    /* NOTE: the last object of the backing allocator is returned to it instead */
+    if (block == sa->backing->top) {
+        M3C_BumpAllocator_FreeSized(sa->backing, block, cap + M3C_SEGREGATED_HEADER_SIZE);
+        return;
+    }
+
+    cls = __M3C_SegregatedAllocator_ClassOf(cap);
+
+    __M3C_SEGREGATED_NEXT(ptr) = sa->freeLists[cls];
+    sa->freeLists[cls] = ptr;
+}
+
+void *M3C_SegregatedAllocator_Realloc(M3C_SegregatedAllocator *sa, void *ptr, m3c_size_t new_size) {
+    void *res;
+    char *block;
+    m3c_size_t cap;
+    m3c_size_t new_cap;
+
+    if (!ptr)
+        return M3C_SegregatedAllocator_Alloc(sa, new_size);
+
+    cap = __M3C_SEGREGATED_CAP(ptr);
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    ++sa->stats.reallocs;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+    /* NOTE: we don't shrink objects. It is cheaper to keep the slack than to copy */
+    if (new_size <= cap)
+        return ptr;
+
+    /* NOTE: the last object of the backing allocator grows in place (as a growing vector usually
+     * is the last one) */
+    block = (char *)ptr - M3C_SEGREGATED_HEADER_SIZE;
+    if (new_size <= M3C_SEGREGATED_MAX_CLASS_SIZE && block == sa->backing->top) {
+        new_cap = (m3c_size_t)M3C_SEGREGATED_MIN_CLASS_SIZE
+                  << __M3C_SegregatedAllocator_ClassOf(new_size);
+
+        if (M3C_BumpAllocator_ReallocAligned(
+                sa->backing, block, M3C_FUNDAMENTAL_ALIGN, new_cap + M3C_SEGREGATED_HEADER_SIZE
+            )) {
+            __M3C_SEGREGATED_CAP(ptr) = new_cap;
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+            __M3C_SEGREGATED_STATS_LIVE(sa, new_cap - cap);
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+            return ptr;
+        }
+    }
+
+    res = __M3C_SegregatedAllocator_AllocObject(sa, new_size);
+    if (!res)
+        return M3C_NULL;
+
+    m3c_memcpy(res, ptr, cap);
+    __M3C_SegregatedAllocator_FreeObject(sa, ptr);
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    ++sa->stats.copyingReallocs;
+    sa->stats.copiedBytes += cap;
+    __M3C_SEGREGATED_STATS_LIVE(sa, __M3C_SEGREGATED_CAP(res) - cap);
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+    return res;
+}
+
+void M3C_SegregatedAllocator_Free(M3C_SegregatedAllocator *sa, void *ptr) {
+    if (!ptr)
+        return;
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    ++sa->stats.frees;
+    sa->stats.liveBytes -= __M3C_SEGREGATED_CAP(ptr) + M3C_SEGREGATED_HEADER_SIZE;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+    __M3C_SegregatedAllocator_FreeObject(sa, ptr);
+}
+
+void M3C_SegregatedAllocator_Mark(M3C_SegregatedAllocator *sa, M3C_SegregatedAllocatorMark *mark) {
+    int i;
+
+    mark->backing = M3C_BumpAllocator_Mark(sa->backing);
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    mark->liveBytes = sa->stats.liveBytes;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+
+    for (i = 0; i < M3C_SEGREGATED_CLASSES; ++i) {
+        mark->freeLists[i] = sa->freeLists[i];
+        sa->freeLists[i] = M3C_NULL;
+    }
+}
+
+void M3C_SegregatedAllocator_Release(
+    M3C_SegregatedAllocator *sa, const M3C_SegregatedAllocatorMark *mark
+) {
+    int i;
+
+    /* NOTE: current free lists may hold objects after the checkpoint, so they are just dropped */
+    for (i = 0; i < M3C_SEGREGATED_CLASSES; ++i)
+        sa->freeLists[i] = mark->freeLists[i];
+
+    M3C_BumpAllocator_Release(sa->backing, mark->backing);
+
+#    ifdef M3C_FEATURE_ALLOC_STATS
+    sa->stats.liveBytes = mark->liveBytes;
+#    endif /* M3C_FEATURE_ALLOC_STATS */
+}
+
+#endif /* M3C_FUNDAMENTAL_ALIGN */
@@ -0,0 +1,54 @@
+#include <m3c/rt/linux/file.h>
+
+#include <m3c/rt/syscalls.h>
+
+/**
+ * \brief Buffer of empty files.
+ */
+static m3c_u8 const __m3c_emptyFile[1] = {0};
+
+M3C_ERROR M3C_File_Map(char const *path, M3C_FileMapping *mapping) {
+    struct stat st;
+    void *addr;
+    int fd;
+
+    fd = m3c_syscall_open(path, O_RDONLY);
+    if (M3C_IsRawErrno(fd))
+        return M3C_ERROR_IO;
+
+    if (M3C_IsRawErrno(m3c_syscall_fstat(fd, &st)) || st.st_size < 0) {
+        m3c_syscall_close(fd);
+        return M3C_ERROR_IO;
+    }
+
+    /* NOTE: `mmap` fails on zero length */
+    if (st.st_size == 0) {
+        m3c_syscall_close(fd);
+
+        mapping->ptr = __m3c_emptyFile;
+        mapping->len = 0;
+
+        return M3C_ERROR_OK;
+    }
+
+    addr = m3c_syscall_mmap(M3C_NULL, (long)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    /* NOTE: the mapping holds its own reference to the file */
+    m3c_syscall_close(fd);
+
+    if (M3C_IsRawErrno(addr))
+        return M3C_ERROR_IO;
+
+    /* NOTE: it's only a hint, so the result is ignored */
+    m3c_syscall_madvise(addr, (long)st.st_size, MADV_SEQUENTIAL);
+
+    mapping->ptr = (m3c_u8 const *)addr;
+    mapping->len = (m3c_size_t)st.st_size;
+
+    return M3C_ERROR_OK;
+}
+
+void M3C_File_Unmap(M3C_FileMapping const *mapping) {
+    if (mapping->len)
+        m3c_syscall_munmap((void *)mapping->ptr, (long)mapping->len);
+}
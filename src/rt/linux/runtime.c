@@ -1,55 +1,833 @@
 #include <m3c/rt/linux/runtime.h>
 
+#include <m3c/common/utf8.h>
+
+#include <m3c/rt/mem.h>
+#include <m3c/rt/scan.h>
 #include <m3c/rt/allocator/bump.h>
+#include <m3c/rt/allocator/segregated.h>
 
-typedef struct __tagM3C_Runtime {
+/**
+ * \brief Default size of the heap address space.
+ *
+ * \note Linux doesn't **really** allocate it anyway, it's only reserved.
+ */
+#define __M3C_RUNTIME_DEFAULT_HEAP_SIZE ((m3c_size_t)4 * M3C_GiB)
+
+/**
+ * \brief Size of the chunk the heap grows by.
+ *
+ * \note Should be a multiple of the huge page size.
+ */
+#define __M3C_RUNTIME_HEAP_CHUNK_SIZE ((m3c_size_t)32 * M3C_MiB)
+
+/**
+ * \brief Page size the heap size is rounded up to.
+ */
+#define __M3C_RUNTIME_PAGE_SIZE ((m3c_size_t)4 * M3C_KiB)
+
+/**
+ * \brief Size of the thread stack mapping (including the thread descriptor).
+ */
+#define __M3C_RUNTIME_THREAD_STACK_SIZE ((m3c_size_t)8 * M3C_MiB)
+
+struct __tagM3C_RuntimeRange {
     /**
-     * \brief File descriptor of `/dev/zero`.
+     * \brief Next range of the list (or `NULL`).
+     */
+    M3C_RuntimeRange *next;
+    /**
+     * \brief Size of the range in bytes (including the descriptor).
+     */
+    m3c_size_t size;
+};
+
+struct __tagM3C_RuntimeThread {
+    /**
+     * \brief Pointer to this descriptor.
+     *
+     * \details The thread pointer (`fs` base) points to the descriptor, so the current thread is
+     * found by reading its first word.
      *
-     * \details Used in `mmap` calls.
+     * \note Must be the first field.
+     */
+    M3C_RuntimeThread *self;
+    /**
+     * \brief Arena allocator.
+     *
+     * \details Backing allocator of \ref M3C_RuntimeThread::allocator "allocator". Allocates from
+     * the current range of the heap claimed by this thread (the first one of \ref
+     * M3C_RuntimeThread::ranges "ranges").
+     */
+    M3C_BumpAllocator arena;
+    /**
+     * \brief Ranges of the heap claimed by this thread (the latest first).
+     *
+     * \details They are returned to the runtime when the thread is joined.
+     */
+    M3C_RuntimeRange *ranges;
+    /**
+     * \brief Thread allocator.
+     */
+    M3C_SegregatedAllocator allocator;
+    /**
+     * \brief Thread id.
+     *
+     * \details Set by the kernel on `clone` and cleared (with futex wake) when the thread exits.
+     */
+    int tid;
+    /**
+     * \brief Result of the thread procedure.
      */
-    int zero;
+    int result;
+    /**
+     * \brief Thread procedure.
+     */
+    M3C_ThreadProcCB proc;
+    /**
+     * \brief Argument of the thread procedure.
+     */
+    void *arg;
+    /**
+     * \brief Address of the stack mapping (`NULL` for the main thread).
+     */
+    void *stack;
+};
+
+typedef struct __tagM3C_Runtime {
     /**
      * \brief Heap address.
+     *
+     * \details Start of the reserved heap address space.
      */
     void *heap;
     /**
-     * \brief Global allocator.
+     * \brief Size of the reserved heap address space.
+     */
+    m3c_size_t heapSize;
+    /**
+     * \brief Number of bytes of the heap claimed by arenas.
+     *
+     * \note Must be accessed atomically.
+     */
+    m3c_size_t heapClaimed;
+    /**
+     * \brief Ranges of the heap returned by arenas.
+     *
+     * \details Sorted by address, adjacent ranges are merged. Arenas are refilled from them before
+     * the heap grows.
+     *
+     * \note Guarded by \ref M3C_Runtime::freeLock "freeLock".
+     */
+    M3C_RuntimeRange *freeRanges;
+    /**
+     * \brief Lock of \ref M3C_Runtime::freeRanges "freeRanges".
+     *
+     * \details Futex word: `1` if locked, `0` otherwise.
+     */
+    int freeLock;
+    /**
+     * \brief Main thread.
      */
-    M3C_BumpAllocator globalAllocator;
+    M3C_RuntimeThread mainThread;
+#ifdef M3C_FEATURE_ALLOC_STATS
+    /**
+     * \brief Summed statistics of joined threads.
+     */
+    M3C_RuntimeStats joinedStats;
+#endif /* M3C_FEATURE_ALLOC_STATS */
 } M3C_Runtime;
 
 static M3C_Runtime __m3c_rt;
 
+char **__m3c_envp;
+
+/**
+ * \brief Returns the value of the environment variable.
+ *
+ * \param[in] name variable name
+ *
+ * \return
+ * + if there is no such variable - `NULL`
+ * + otherwise - variable value
+ */
+const char *__M3C_Runtime_GetEnv(const char *name) {
+    char **env;
+    const char *n;
+    const char *v;
+
+    if (!__m3c_envp)
+        return M3C_NULL;
+
+    for (env = __m3c_envp; *env; ++env) {
+        for (n = name, v = *env; *n && *n == *v; ++n, ++v)
+            ;
+
+        if (!*n && *v == '=')
+            return v + 1;
+    }
+
+    return M3C_NULL;
+}
+
+/**
+ * \brief Parses size with an optional `K`, `M` or `G` suffix.
+ *
+ * \param[in] str string to parse. May be `NULL`
+ * \param     def default value
+ *
+ * \return
+ * + on failure - `def`
+ * + on success - size in bytes
+ */
+m3c_size_t __M3C_Runtime_ParseSize(const char *str, m3c_size_t def) {
+    m3c_size_t size = 0;
+    m3c_size_t unit = 1;
+
+    if (!str || !M3C_InRange(*str, '0', '9'))
+        return def;
+
+    for (; M3C_InRange(*str, '0', '9'); ++str) {
+        if (size > (M3C_SIZE_MAX - 9) / 10)
+            return def;
+
+        size = size * 10 + (m3c_size_t)(*str - '0');
+    }
+
+    switch (*str) {
+    case 'K':
+    case 'k':
+        unit = M3C_KiB;
+        ++str;
+        break;
+    case 'M':
+    case 'm':
+        unit = M3C_MiB;
+        ++str;
+        break;
+    case 'G':
+    case 'g':
+        unit = M3C_GiB;
+        ++str;
+        break;
+    }
+
+    if (*str || size > M3C_SIZE_MAX / unit)
+        return def;
+
+    return size * unit;
+}
+
+/**
+ * \brief Returns the current thread.
+ */
+M3C_RuntimeThread *__M3C_Runtime_CurrentThread(void) {
+    M3C_RuntimeThread *thread;
+
+    __asm__("mov %%fs:0, %0" : "=r"(thread));
+
+    return thread;
+}
+
+/**
+ * \brief Locks \ref M3C_Runtime::freeRanges "free ranges".
+ */
+void __M3C_Runtime_LockFreeRanges(void) {
+    int unlocked = 0;
+
+    while (!m3c_atomic_compare_exchange(&__m3c_rt.freeLock, &unlocked, 1)) {
+        m3c_syscall_futex(&__m3c_rt.freeLock, FUTEX_WAIT, 1, M3C_NULL, M3C_NULL, 0);
+        unlocked = 0;
+    }
+}
+
+/**
+ * \brief Unlocks \ref M3C_Runtime::freeRanges "free ranges".
+ */
+void __M3C_Runtime_UnlockFreeRanges(void) {
+    m3c_atomic_store(&__m3c_rt.freeLock, 0);
+    m3c_syscall_futex(&__m3c_rt.freeLock, FUTEX_WAKE, 1, M3C_NULL, M3C_NULL, 0);
+}
+
+/**
+ * \brief Returns the range to \ref M3C_Runtime::freeRanges "free ranges".
+ *
+ * \note Free ranges must be locked.
+ *
+ * \param[in,out] range range. Its \ref M3C_RuntimeRange::size "size" must be set
+ */
+void __M3C_Runtime_FreeRange(M3C_RuntimeRange *range) {
+    M3C_RuntimeRange **link = &__m3c_rt.freeRanges;
+    M3C_RuntimeRange *prev = M3C_NULL;
+
+    while (*link && *link < range) {
+        prev = *link;
+        link = &prev->next;
+    }
+
+    range->next = *link;
+    *link = range;
+
+    /* NOTE: adjacent ranges are merged, so multi-chunk objects fit in them again */
+    if (range->next && (char *)range + range->size == (char *)range->next) {
+        range->size += range->next->size;
+        range->next = range->next->next;
+    }
+    if (prev && (char *)prev + prev->size == (char *)range) {
+        prev->size += range->size;
+        prev->next = range->next;
+    }
+}
+
+/**
+ * \brief Returns all ranges of the list to \ref M3C_Runtime::freeRanges "free ranges".
+ *
+ * \param[in,out] ranges list of ranges. May be `NULL`
+ */
+void __M3C_Runtime_FreeRanges(M3C_RuntimeRange *ranges) {
+    M3C_RuntimeRange *next;
+
+    if (!ranges)
+        return;
+
+    __M3C_Runtime_LockFreeRanges();
+    for (; ranges; ranges = next) {
+        next = ranges->next;
+        __M3C_Runtime_FreeRange(ranges);
+    }
+    __M3C_Runtime_UnlockFreeRanges();
+}
+
+/**
+ * \brief Takes a free range of at least `size` bytes.
+ *
+ * \details The first range that fits is taken. If it's greater by at least a page, the rest stays
+ * free.
+ *
+ * \param size minimum size of the range in bytes. Must be a multiple of the page size
+ *
+ * \return
+ * + if there is no such range - `NULL`
+ * + otherwise - range (with its \ref M3C_RuntimeRange::size "size" set)
+ */
+M3C_RuntimeRange *__M3C_Runtime_TakeFreeRange(m3c_size_t size) {
+    M3C_RuntimeRange **link;
+    M3C_RuntimeRange *range;
+    M3C_RuntimeRange *rest;
+
+    __M3C_Runtime_LockFreeRanges();
+
+    for (link = &__m3c_rt.freeRanges; (range = *link) != M3C_NULL; link = &range->next)
+        if (range->size >= size)
+            break;
+
+    if (range) {
+        if (range->size - size >= __M3C_RUNTIME_PAGE_SIZE) {
+            rest = (M3C_RuntimeRange *)((char *)range + size);
+            rest->next = range->next;
+            rest->size = range->size - size;
+            *link = rest;
+            range->size = size;
+        } else
+            *link = range->next;
+    }
+
+    __M3C_Runtime_UnlockFreeRanges();
+
+    return range;
+}
+
+/**
+ * \brief Claims and commits the next chunks of the heap.
+ *
+ * \details Chunks are claimed with an atomic bump, so threads grow the heap without locks.
+ *
+ * \param chunks number of chunks to claim (the rest of the heap is claimed if there are less)
+ *
+ * \return
+ * + on failure - `NULL` (nothing was claimed)
+ * + on success - range (with its \ref M3C_RuntimeRange::size "size" set)
+ */
+M3C_RuntimeRange *__M3C_Runtime_ClaimRange(m3c_size_t chunks) {
+    m3c_size_t claimed = m3c_atomic_load(&__m3c_rt.heapClaimed);
+    m3c_size_t rest;
+    m3c_size_t grow;
+    M3C_RuntimeRange *range;
+
+    do {
+        rest = __m3c_rt.heapSize - claimed;
+        if (rest == 0)
+            return M3C_NULL;
+
+        if (chunks <= rest / __M3C_RUNTIME_HEAP_CHUNK_SIZE)
+            grow = chunks * __M3C_RUNTIME_HEAP_CHUNK_SIZE;
+        else
+            grow = rest;
+    } while (!m3c_atomic_compare_exchange(&__m3c_rt.heapClaimed, &claimed, claimed + grow));
+
+    range = (M3C_RuntimeRange *)((char *)__m3c_rt.heap + claimed);
+
+    /* NOTE: if it fails the chunks are lost, but there is nothing we can do */
+    if (M3C_IsRawErrno(m3c_syscall_mprotect(range, (long)grow, PROT_READ | PROT_WRITE)))
+        return M3C_NULL;
+
+    range->size = grow;
+
+    return range;
+}
+
+/**
+ * \brief Refills the thread arena.
+ *
+ * \details Takes enough heap to allocate an object of `size` bytes: a free range returned by
+ * another arena or, if there is no such range, the next chunks of the heap (or the rest of it).
+ *
+ * If the new range follows the current one, the arena is just extended. Otherwise the unused rest
+ * of the current range is returned to free ranges, and the arena switches to the new range.
+ *
+ * \param[in,out] thread thread to refill arena of
+ * \param         size   size of the object that failed to be allocated
+ *
+ * \return
+ * + on failure - `0` (nothing was claimed)
+ * + on success - `1`
+ */
+int __M3C_Runtime_RefillArena(M3C_RuntimeThread *thread, m3c_size_t size) {
+    M3C_RuntimeRange *cur = thread->ranges;
+    M3C_RuntimeRange *range = M3C_NULL;
+    M3C_RuntimeRange *tail;
+    m3c_size_t chunks;
+#ifdef M3C_FEATURE_ALLOC_STATS
+    M3C_BumpAllocatorStats stats;
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+    /* NOTE: one more chunk leaves room for alignment, the object header and the range descriptor */
+    chunks = size / __M3C_RUNTIME_HEAP_CHUNK_SIZE + 1;
+
+    if (chunks <= __m3c_rt.heapSize / __M3C_RUNTIME_HEAP_CHUNK_SIZE)
+        range = __M3C_Runtime_TakeFreeRange(chunks * __M3C_RUNTIME_HEAP_CHUNK_SIZE);
+    if (!range)
+        range = __M3C_Runtime_ClaimRange(chunks);
+    if (!range)
+        return 0;
+
+    /* NOTE: if the range follows the current one, the arena is just extended */
+    if (cur && (char *)cur + cur->size == (char *)range) {
+        cur->size += range->size;
+        thread->arena.last = (char *)cur + cur->size - 1;
+
+        return 1;
+    }
+
+    /* NOTE: the rest of the current range is never allocated from again, so it's returned */
+    if (cur) {
+        tail = (M3C_RuntimeRange *)(((m3c_size_t)thread->arena.ptr + __M3C_RUNTIME_PAGE_SIZE - 1) &
+                                    ~(__M3C_RUNTIME_PAGE_SIZE - 1));
+
+        if ((m3c_size_t)((char *)cur + cur->size - (char *)tail) >= __M3C_RUNTIME_PAGE_SIZE) {
+            tail->size = (m3c_size_t)((char *)cur + cur->size - (char *)tail);
+            cur->size -= tail->size;
+
+            __M3C_Runtime_LockFreeRanges();
+            __M3C_Runtime_FreeRange(tail);
+            __M3C_Runtime_UnlockFreeRanges();
+        }
+    }
+
+    range->next = cur;
+    thread->ranges = range;
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+    stats = thread->arena.stats;
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+    M3C_BumpAllocator_New(&thread->arena, range + 1, (char *)range + range->size - 1);
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+    thread->arena.stats = stats;
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+    return 1;
+}
+
+/**
+ * \brief Maps private zeroed pages for a large object.
+ *
+ * \param size mapping length
+ *
+ * \return
+ * + on failure - `NULL`
+ * + on success - address of mapping
+ */
+void *__M3C_Runtime_MapPages(m3c_size_t size) {
+    void *addr = m3c_syscall_mmap(
+        M3C_NULL, (long)size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0
+    );
+
+    return M3C_IsRawErrno(addr) ? M3C_NULL : addr;
+}
+
+/**
+ * \brief Unmaps pages mapped by #__M3C_Runtime_MapPages.
+ *
+ * \param ptr  address of mapping
+ * \param size mapping length
+ */
+void __M3C_Runtime_UnmapPages(void *ptr, m3c_size_t size) {
+    /* NOTE: there is nothing we can do if it fails */
+    m3c_syscall_munmap(ptr, (long)size);
+}
+
+/**
+ * \brief Inits the thread descriptor and refills its arena.
+ *
+ * \param[out] thread thread descriptor
+ *
+ * \return
+ * + on failure - `0`
+ * + on success - `1`
+ */
+int __M3C_Runtime_InitThread(M3C_RuntimeThread *thread) {
+    thread->self = thread;
+    thread->ranges = M3C_NULL;
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+    m3c_memset(&thread->arena.stats, 0, sizeof(thread->arena.stats));
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+    if (!__M3C_Runtime_RefillArena(thread, 0))
+        return 0;
+
+    M3C_SegregatedAllocator_New(
+        &thread->allocator, &thread->arena, __M3C_Runtime_MapPages, __M3C_Runtime_UnmapPages
+    );
+
+    return 1;
+}
+
 int M3C_Runtime_New(void) {
-    /* NOTE: should be greater then zero
-     * NOTE: we use 4GiB at the start as Linux doesn't **really** allocate it anyway
-     */
-    long heapSize = 4 * M3C_GiB;
+    const char *hugePages;
 
-    /* NOTE: we don't check the result here, as we called `mmap` later with the this fd */
-    __m3c_rt.zero = m3c_syscall_open("/dev/zero", O_RDWR);
+    M3C_Mem_Init();
+    M3C_Scan_Init();
+    M3C_UTF8_Init();
 
-    __m3c_rt.heap =
-        m3c_syscall_mmap(M3C_NULL, heapSize, PROT_READ | PROT_WRITE, MAP_SHARED, __m3c_rt.zero, 0);
-    if (M3C_IsRawErrno(__m3c_rt.heap))
+    /* NOTE: should be greater then zero and a multiple of the page size */
+    __m3c_rt.heapSize = __M3C_Runtime_ParseSize(
+        __M3C_Runtime_GetEnv(M3C_RUNTIME_ENV_HEAP_SIZE), __M3C_RUNTIME_DEFAULT_HEAP_SIZE
+    );
+    __m3c_rt.heapSize = (__m3c_rt.heapSize + __M3C_RUNTIME_PAGE_SIZE - 1) &
+                        ~(__M3C_RUNTIME_PAGE_SIZE - 1);
+    if (__m3c_rt.heapSize == 0)
         return -1;
 
-    M3C_BumpAllocator_New(
-        &__m3c_rt.globalAllocator, __m3c_rt.heap, (char *)__m3c_rt.heap + heapSize - 1
+    /* NOTE: the address space is only reserved. Chunks are committed with `mprotect` */
+    __m3c_rt.heap = m3c_syscall_mmap(
+        M3C_NULL, (long)__m3c_rt.heapSize, PROT_NONE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0
     );
+    if (M3C_IsRawErrno(__m3c_rt.heap))
+        return -1;
+    __m3c_rt.heapClaimed = 0;
+    __m3c_rt.freeRanges = M3C_NULL;
+
+    /* NOTE: huge pages are only an advice, so we don't check the result */
+    hugePages = __M3C_Runtime_GetEnv(M3C_RUNTIME_ENV_HEAP_HUGEPAGES);
+    if (!hugePages || hugePages[0] != '0' || hugePages[1] != '\0')
+        m3c_syscall_madvise(__m3c_rt.heap, (long)__m3c_rt.heapSize, MADV_HUGEPAGE);
+
+    if (!__M3C_Runtime_InitThread(&__m3c_rt.mainThread))
+        return -1;
+    __m3c_rt.mainThread.stack = M3C_NULL;
+
+    if (M3C_IsRawErrno(
+            m3c_syscall_arch_prctl(ARCH_SET_FS, (unsigned long)&__m3c_rt.mainThread)
+        ))
+        return -1;
 
     return 0;
 }
 
+/**
+ * \brief Entry point of spawned threads.
+ *
+ * \param[in,out] arg thread descriptor
+ *
+ * \return result of the thread procedure
+ */
+int __M3C_Runtime_ThreadMain(void *arg) {
+    M3C_RuntimeThread *thread = arg;
+
+    thread->result = thread->proc(thread->arg);
+
+    return thread->result;
+}
+
+M3C_RuntimeThread *M3C_Runtime_SpawnThread(M3C_ThreadProcCB proc, void *arg) {
+    char *stack;
+    M3C_RuntimeThread *thread;
+    long tid;
+
+    stack = m3c_syscall_mmap(
+        M3C_NULL, (long)__M3C_RUNTIME_THREAD_STACK_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0
+    );
+    if (M3C_IsRawErrno(stack))
+        return M3C_NULL;
+
+    /* NOTE: the descriptor is placed at the top of the mapping, the stack grows down below it */
+    thread = (M3C_RuntimeThread *)(stack + __M3C_RUNTIME_THREAD_STACK_SIZE) - 1;
+    if (!__M3C_Runtime_InitThread(thread)) {
+        m3c_syscall_munmap(stack, (long)__M3C_RUNTIME_THREAD_STACK_SIZE);
+        return M3C_NULL;
+    }
+    thread->proc = proc;
+    thread->arg = arg;
+    thread->stack = stack;
+
+    tid = m3c_syscall_clone(
+        CLONE_VM | CLONE_FS | CLONE_FILES | CLONE_SIGHAND | CLONE_THREAD | CLONE_SYSVSEM |
+            CLONE_SETTLS | CLONE_PARENT_SETTID | CLONE_CHILD_CLEARTID,
+        thread, &thread->tid, &thread->tid, (unsigned long)thread, __M3C_Runtime_ThreadMain, thread
+    );
+    if (M3C_IsRawErrno(tid)) {
+        __M3C_Runtime_FreeRanges(thread->ranges);
+        m3c_syscall_munmap(stack, (long)__M3C_RUNTIME_THREAD_STACK_SIZE);
+        return M3C_NULL;
+    }
+
+    return thread;
+}
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+/**
+ * \brief Adds statistics of the thread to `stats`.
+ */
+void __M3C_Runtime_AddStats(M3C_RuntimeStats *stats, const M3C_RuntimeThread *thread) {
+    const M3C_SegregatedAllocatorStats *as = &thread->allocator.stats;
+    const M3C_BumpAllocatorStats *bs = &thread->arena.stats;
+    int i;
+
+    stats->allocator.allocs += as->allocs;
+    stats->allocator.allocatedBytes += as->allocatedBytes;
+    stats->allocator.reallocs += as->reallocs;
+    stats->allocator.copyingReallocs += as->copyingReallocs;
+    stats->allocator.copiedBytes += as->copiedBytes;
+    stats->allocator.frees += as->frees;
+    stats->allocator.liveBytes += as->liveBytes;
+    stats->allocator.peakLiveBytes += as->peakLiveBytes;
+    for (i = 0; i < M3C_SEGREGATED_STATS_BUCKETS; ++i)
+        stats->allocator.histogram[i] += as->histogram[i];
+
+    stats->arena.inPlaceReallocs += bs->inPlaceReallocs;
+    stats->arena.copyingReallocs += bs->copyingReallocs;
+    stats->arena.copiedBytes += bs->copiedBytes;
+    stats->arena.paddingBytes += bs->paddingBytes;
+}
+
+void M3C_Runtime_GetStats(M3C_RuntimeStats *stats) {
+    *stats = __m3c_rt.joinedStats;
+    stats->heapSize = __m3c_rt.heapSize;
+    stats->heapClaimed = m3c_atomic_load(&__m3c_rt.heapClaimed);
+
+    __M3C_Runtime_AddStats(stats, &__m3c_rt.mainThread);
+}
+
+/**
+ * \brief Appends the string to the buffer.
+ *
+ * \return end of the appended string
+ */
+char *__M3C_Runtime_PutStr(char *buf, const char *str) {
+    while (*str)
+        *buf++ = *str++;
+
+    return buf;
+}
+
+/**
+ * \brief Appends the decimal number to the buffer.
+ *
+ * \return end of the appended number
+ */
+char *__M3C_Runtime_PutNum(char *buf, m3c_size_t num) {
+    char digits[24];
+    int len = 0;
+
+    do {
+        digits[len++] = (char)('0' + num % 10);
+        num /= 10;
+    } while (num);
+
+    while (len)
+        *buf++ = digits[--len];
+
+    return buf;
+}
+
+/**
+ * \brief Prints allocation statistics to `stderr`.
+ */
+void __M3C_Runtime_DumpStats(void) {
+    M3C_RuntimeStats stats;
+    char buf[4096];
+    char *ptr = buf;
+    int i;
+
+    M3C_Runtime_GetStats(&stats);
+
+    ptr = __M3C_Runtime_PutStr(ptr, "m3c: heap claimed ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.heapClaimed);
+    ptr = __M3C_Runtime_PutStr(ptr, " of ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.heapSize);
+    ptr = __M3C_Runtime_PutStr(ptr, " bytes\nm3c: allocs ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.allocs);
+    ptr = __M3C_Runtime_PutStr(ptr, " (");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.allocatedBytes);
+    ptr = __M3C_Runtime_PutStr(ptr, " bytes), frees ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.frees);
+    ptr = __M3C_Runtime_PutStr(ptr, "\nm3c: reallocs ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.reallocs);
+    ptr = __M3C_Runtime_PutStr(ptr, " (");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.copyingReallocs);
+    ptr = __M3C_Runtime_PutStr(ptr, " copying ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.copiedBytes);
+    ptr = __M3C_Runtime_PutStr(ptr, " bytes, ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.arena.inPlaceReallocs);
+    ptr = __M3C_Runtime_PutStr(ptr, " in place)\nm3c: live ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.liveBytes);
+    ptr = __M3C_Runtime_PutStr(ptr, " bytes, peak ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.peakLiveBytes);
+    ptr = __M3C_Runtime_PutStr(ptr, " bytes, padding ");
+    ptr = __M3C_Runtime_PutNum(ptr, stats.arena.paddingBytes);
+    ptr = __M3C_Runtime_PutStr(ptr, " bytes\nm3c: allocation sizes:\n");
+
+    for (i = 0; i < M3C_SEGREGATED_STATS_BUCKETS; ++i) {
+        if (!stats.allocator.histogram[i])
+            continue;
+
+        /* NOTE: the last bucket counts all sizes greater than the previous one */
+        if (i == M3C_SEGREGATED_STATS_BUCKETS - 1) {
+            ptr = __M3C_Runtime_PutStr(ptr, "m3c:   >  ");
+            ptr = __M3C_Runtime_PutNum(ptr, (m3c_size_t)1 << (i - 1));
+        } else {
+            ptr = __M3C_Runtime_PutStr(ptr, "m3c:   <= ");
+            ptr = __M3C_Runtime_PutNum(ptr, (m3c_size_t)1 << i);
+        }
+        ptr = __M3C_Runtime_PutStr(ptr, ": ");
+        ptr = __M3C_Runtime_PutNum(ptr, stats.allocator.histogram[i]);
+        ptr = __M3C_Runtime_PutStr(ptr, "\n");
+    }
+
+    m3c_syscall_write(2, buf, ptr - buf);
+}
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+void __M3C_Runtime_AtExit(void) {
+#ifdef M3C_FEATURE_ALLOC_STATS
+    /* NOTE: the runtime may be not inited */
+    if (__m3c_rt.heap)
+        __M3C_Runtime_DumpStats();
+#endif /* M3C_FEATURE_ALLOC_STATS */
+}
+
+int M3C_Runtime_JoinThread(M3C_RuntimeThread *thread) {
+    int tid;
+    int result;
+
+    /* NOTE: the kernel clears `tid` and wakes us when the thread exits */
+    while ((tid = m3c_atomic_load(&thread->tid)) != 0)
+        m3c_syscall_futex(&thread->tid, FUTEX_WAIT, tid, M3C_NULL, M3C_NULL, 0);
+
+    result = thread->result;
+
+#ifdef M3C_FEATURE_ALLOC_STATS
+    __M3C_Runtime_AddStats(&__m3c_rt.joinedStats, thread);
+#endif /* M3C_FEATURE_ALLOC_STATS */
+
+    /* NOTE: the descriptor is on the stack, so the ranges are returned before it's unmapped */
+    __M3C_Runtime_FreeRanges(thread->ranges);
+    m3c_syscall_munmap(thread->stack, (long)__M3C_RUNTIME_THREAD_STACK_SIZE);
+
+    return result;
+}
+
+void M3C_Runtime_Wait(int *word, int value) {
+    /* NOTE: the kernel rechecks the word, so a signal between the load and the wait isn't lost */
+    while (m3c_atomic_load(word) == value)
+        m3c_syscall_futex(word, FUTEX_WAIT, value, M3C_NULL, M3C_NULL, 0);
+}
+
+void M3C_Runtime_Signal(int *word, int value) {
+    m3c_atomic_store(word, value);
+    m3c_syscall_futex(word, FUTEX_WAKE, 0x7FFFFFFF, M3C_NULL, M3C_NULL, 0);
+}
+
+void M3C_Runtime_EnterScope(M3C_RuntimeScope *scope) {
+    M3C_RuntimeThread *thread = __M3C_Runtime_CurrentThread();
+
+    M3C_SegregatedAllocator_Mark(&thread->allocator, &scope->mark);
+    scope->range = thread->ranges;
+    scope->rangeSize = thread->ranges->size;
+}
+
+void M3C_Runtime_LeaveScope(const M3C_RuntimeScope *scope) {
+    M3C_RuntimeThread *thread = __M3C_Runtime_CurrentThread();
+    M3C_RuntimeRange *range = scope->range;
+    M3C_RuntimeRange *next;
+    M3C_RuntimeRange *tail;
+
+    /* NOTE: the arena is switched back to the range of the scope */
+    M3C_SegregatedAllocator_Release(&thread->allocator, &scope->mark);
+
+    /* NOTE: the ranges claimed inside the scope (and the extension of the range of the scope) are
+     * returned. The range may also be trimmed by a refill, then its returned rest stays free */
+    if (thread->ranges != range || range->size > scope->rangeSize) {
+        __M3C_Runtime_LockFreeRanges();
+
+        for (; thread->ranges != range; thread->ranges = next) {
+            next = thread->ranges->next;
+            __M3C_Runtime_FreeRange(thread->ranges);
+        }
+
+        if (range->size > scope->rangeSize) {
+            tail = (M3C_RuntimeRange *)((char *)range + scope->rangeSize);
+            tail->size = range->size - scope->rangeSize;
+            range->size = scope->rangeSize;
+            __M3C_Runtime_FreeRange(tail);
+        }
+
+        __M3C_Runtime_UnlockFreeRanges();
+    }
+
+    thread->arena.last = (char *)range + range->size - 1;
+}
+
 void *__M3C_Runtime_Malloc(m3c_size_t size) {
-    return M3C_BumpAllocator_Alloc(&__m3c_rt.globalAllocator, size);
+    M3C_RuntimeThread *thread = __M3C_Runtime_CurrentThread();
+    void *res = M3C_SegregatedAllocator_Alloc(&thread->allocator, size);
+
+    /* NOTE: the arena may be exhausted. A large object isn't taken from the arena, so refilling
+     * it wouldn't help */
+    if (!res && size <= M3C_SEGREGATED_MAX_CLASS_SIZE && __M3C_Runtime_RefillArena(thread, size))
+        res = M3C_SegregatedAllocator_Alloc(&thread->allocator, size);
+
+    return res;
 }
 
 void *__M3C_Runtime_Realloc(void *ptr, m3c_size_t new_size) {
-    return M3C_BumpAllocator_Realloc(&__m3c_rt.globalAllocator, ptr, new_size);
+    M3C_RuntimeThread *thread = __M3C_Runtime_CurrentThread();
+    void *res = M3C_SegregatedAllocator_Realloc(&thread->allocator, ptr, new_size);
+
+    /* NOTE: the arena may be exhausted. A large object isn't taken from the arena, so refilling
+     * it wouldn't help */
+    if (!res && new_size <= M3C_SEGREGATED_MAX_CLASS_SIZE &&
+        __M3C_Runtime_RefillArena(thread, new_size))
+        res = M3C_SegregatedAllocator_Realloc(&thread->allocator, ptr, new_size);
+
+    return res;
 }
 
 void __M3C_Runtime_Free(void *ptr) {
-    return M3C_BumpAllocator_Free(&__m3c_rt.globalAllocator, ptr);
+    M3C_SegregatedAllocator_Free(&__M3C_Runtime_CurrentThread()->allocator, ptr);
 }
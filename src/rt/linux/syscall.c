@@ -10,6 +10,24 @@ int m3c_syscall_open(const char *path, int flags) {
 int m3c_syscall_close(int fd) { return (int)m3c_syscall1(SYS_close, (long)fd); }
 #endif /* SYS_close */
 
+#ifdef SYS_write
+long m3c_syscall_write(int fd, const void *buf, long count) {
+    return m3c_syscall3(SYS_write, (long)fd, (long)buf, count);
+}
+#endif /* SYS_write */
+
+#ifdef SYS_stat
+int m3c_syscall_stat(const char *path, struct stat *statbuf) {
+    return (int)m3c_syscall2(SYS_stat, (long)path, (long)statbuf);
+}
+#endif /* SYS_stat */
+
+#ifdef SYS_fstat
+int m3c_syscall_fstat(int fd, struct stat *statbuf) {
+    return (int)m3c_syscall2(SYS_fstat, (long)fd, (long)statbuf);
+}
+#endif /* SYS_fstat */
+
 #ifdef SYS_mmap
 void *m3c_syscall_mmap(void *addr, long length, int prot, int flags, int fd, long offset) {
     return (void *)m3c_syscall6(
@@ -17,3 +35,35 @@ void *m3c_syscall_mmap(void *addr, long length, int prot, int flags, int fd, lon
     );
 }
 #endif /* SYS_mmap */
+
+#ifdef SYS_munmap
+int m3c_syscall_munmap(void *addr, long length) {
+    return (int)m3c_syscall2(SYS_munmap, (long)addr, length);
+}
+#endif /* SYS_munmap */
+
+#ifdef SYS_mprotect
+int m3c_syscall_mprotect(void *addr, long length, int prot) {
+    return (int)m3c_syscall3(SYS_mprotect, (long)addr, length, (long)prot);
+}
+#endif /* SYS_mprotect */
+
+#ifdef SYS_madvise
+int m3c_syscall_madvise(void *addr, long length, int advice) {
+    return (int)m3c_syscall3(SYS_madvise, (long)addr, length, (long)advice);
+}
+#endif /* SYS_madvise */
+
+#ifdef SYS_futex
+long m3c_syscall_futex(int *uaddr, int op, int val, const void *timeout, int *uaddr2, int val3) {
+    return m3c_syscall6(
+        SYS_futex, (long)uaddr, (long)op, (long)val, (long)timeout, (long)uaddr2, (long)val3
+    );
+}
+#endif /* SYS_futex */
+
+#ifdef SYS_arch_prctl
+int m3c_syscall_arch_prctl(int code, unsigned long addr) {
+    return (int)m3c_syscall2(SYS_arch_prctl, (long)code, (long)addr);
+}
+#endif /* SYS_arch_prctl */
@@ -1,42 +1,223 @@
 #include <m3c/rt/mem.h>
 
-void *m3c_memfill(
-    void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t len, m3c_size_t count
-) {
-    const char *end = (char *)dest + len * count; /* P+N */
-    char *ptr = dest;
-    for (; ptr < end; ptr += len) {
-        m3c_memcpy(ptr, src, len);
+#include <m3c/rt/x86-64/mem.h>
+
+#ifndef M3C_FEATURE_USE_COMPILER_BUILTIN_FUNCTIONS
+
+/**
+ * \brief Machine word used by word-at-a-time functions.
+ */
+#    if defined(M3C_GNUC) || defined(M3C_CLANG)
+typedef m3c_size_t __attribute__((may_alias)) __M3C_Word;
+#    else
+typedef m3c_size_t __M3C_Word;
+#    endif
+
+#    define __M3C_WORD_SIZE sizeof(__M3C_Word)
+
+/**
+ * \brief Returns non-zero if `ptr` is aligned to the word size.
+ */
+#    define __M3C_IS_WORD_ALIGNED(ptr) ((m3c_size_t)(ptr) % __M3C_WORD_SIZE == 0)
+
+/**
+ * \brief Word-at-a-time version of `m3c_memcpy`.
+ *
+ * \details Copies bytes until `dest` is aligned, then copies whole words if `src` is aligned too.
+ */
+void *__M3C_Memcpy_Word(void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t count) {
+    unsigned char *_dest = dest;
+    unsigned char const *_src = src;
+
+    for (; count > 0 && !__M3C_IS_WORD_ALIGNED(_dest); --count)
+        *_dest++ = *_src++;
+
+    if (__M3C_IS_WORD_ALIGNED(_src)) {
+        for (; count >= __M3C_WORD_SIZE; count -= __M3C_WORD_SIZE) {
+            *(__M3C_Word *)_dest = *(const __M3C_Word *)_src;
+
+            _dest += __M3C_WORD_SIZE;
+            _src += __M3C_WORD_SIZE;
+        }
+    }
+
+    for (; count > 0; --count)
+        *_dest++ = *_src++;
+
+    return dest;
+}
+
+/**
+ * \brief Returns byte `i % 8` of the 8-byte pattern.
+ */
+#    define __M3C_PATTERN_BYTE(pattern, i) ((unsigned char)((pattern) >> (8 * ((i) % 8))))
+
+/**
+ * \brief Word-at-a-time fill of `count` bytes of `dest` with the repeated 8-byte `pattern`.
+ *
+ * \details Byte `i` of `dest` is set to byte `i % 8` of the pattern (bytes of the pattern are
+ * counted from the least significant one).
+ */
+void *__M3C_MemsetPattern_Word(void *dest, unsigned long long pattern, m3c_size_t count) {
+    unsigned char *_dest = dest;
+    m3c_size_t i = 0;
+    m3c_size_t j;
+    /* NOTE: if the word is less than 8 bytes, consecutive words have different phases. So we
+     * store two words at once */
+    union {
+        __M3C_Word word[2];
+        unsigned char bytes[2 * __M3C_WORD_SIZE];
+    } words;
+
+    for (; i < count && !__M3C_IS_WORD_ALIGNED(_dest + i); ++i)
+        _dest[i] = __M3C_PATTERN_BYTE(pattern, i);
+
+    for (j = 0; j < 2 * __M3C_WORD_SIZE; ++j)
+        words.bytes[j] = __M3C_PATTERN_BYTE(pattern, i + j);
+
+    for (; count - i >= 2 * __M3C_WORD_SIZE; i += 2 * __M3C_WORD_SIZE) {
+        ((__M3C_Word *)(_dest + i))[0] = words.word[0];
+        ((__M3C_Word *)(_dest + i))[1] = words.word[1];
     }
+
+    for (; i < count; ++i)
+        _dest[i] = __M3C_PATTERN_BYTE(pattern, i);
+
     return dest;
 }
 
+typedef void *(*__M3C_MemcpyFn)(void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t);
+typedef void *(*__M3C_MemsetPatternFn)(void *dest, unsigned long long pattern, m3c_size_t count);
+
+#    ifdef M3C_X86_64_SIMD
+/* NOTE: SSE2 is a part of x86-64, so it's safe to use it without detection */
+static __M3C_MemcpyFn __m3c_memcpy = __M3C_Memcpy_SSE2;
+static __M3C_MemsetPatternFn __m3c_memset_pattern = __M3C_MemsetPattern_SSE2;
+#    else
+static __M3C_MemcpyFn __m3c_memcpy = __M3C_Memcpy_Word;
+static __M3C_MemsetPatternFn __m3c_memset_pattern = __M3C_MemsetPattern_Word;
+#    endif
+
+void M3C_Mem_Init(void) {
+#    ifdef M3C_X86_64_SIMD
+    if (M3C_CPU_DetectFeatures() & M3C_CPU_FEATURE_AVX2) {
+        __m3c_memcpy = __M3C_Memcpy_AVX2;
+        __m3c_memset_pattern = __M3C_MemsetPattern_AVX2;
+    }
+#    endif
+}
+
 void *m3c_memcpy(void *m3c_restrict dest, const void *m3c_restrict src, size_t count) {
-    /* TODO: this is a VERY inefficient implementation! */
-    unsigned char *_dest = (unsigned char *)dest;
-    unsigned char const *_src = (unsigned char const *)src;
+    return __m3c_memcpy(dest, src, count);
+}
+
+void *m3c_memmove(void *dest, const void *src, m3c_size_t count) {
+    unsigned char *_dest = dest;
+    unsigned char const *_src = src;
+
+    /* NOTE: non overlapping buffers are just copied */
+    if ((m3c_size_t)_dest - (m3c_size_t)_src >= count &&
+        (m3c_size_t)_src - (m3c_size_t)_dest >= count)
+        return __m3c_memcpy(dest, src, count);
+
+    if (_dest == _src)
+        return dest;
 
-    while (count > 0) {
-        *_dest = *_src;
+    if ((m3c_size_t)_dest < (m3c_size_t)_src) {
+        /* NOTE: forward copy is safe as each word is read before it's overwritten */
+        for (; count > 0 && !__M3C_IS_WORD_ALIGNED(_dest); --count)
+            *_dest++ = *_src++;
 
-        ++_dest;
-        ++_src;
-        --count;
+        if (__M3C_IS_WORD_ALIGNED(_src)) {
+            for (; count >= __M3C_WORD_SIZE; count -= __M3C_WORD_SIZE) {
+                *(__M3C_Word *)_dest = *(const __M3C_Word *)_src;
+
+                _dest += __M3C_WORD_SIZE;
+                _src += __M3C_WORD_SIZE;
+            }
+        }
+
+        for (; count > 0; --count)
+            *_dest++ = *_src++;
+    } else {
+        /* NOTE: `dest` is after `src`, so we copy backward from the end */
+        _dest += count;
+        _src += count;
+
+        for (; count > 0 && !__M3C_IS_WORD_ALIGNED(_dest); --count)
+            *--_dest = *--_src;
+
+        if (__M3C_IS_WORD_ALIGNED(_src)) {
+            for (; count >= __M3C_WORD_SIZE; count -= __M3C_WORD_SIZE) {
+                _dest -= __M3C_WORD_SIZE;
+                _src -= __M3C_WORD_SIZE;
+
+                *(__M3C_Word *)_dest = *(const __M3C_Word *)_src;
+            }
+        }
+
+        for (; count > 0; --count)
+            *--_dest = *--_src;
     }
 
     return dest;
 }
 
 void *m3c_memset(void *dest, int ch, m3c_size_t count) {
-    /* TODO: this is a VERY inefficient implementation! */
+    return __m3c_memset_pattern(dest, 0x0101010101010101ULL * (unsigned char)ch, count);
+}
 
-    unsigned char *_dest = dest;
+#endif /* M3C_FEATURE_USE_COMPILER_BUILTIN_FUNCTIONS */
+
+/**
+ * \brief Maximum size of the chunk copied by `m3c_memfill`.
+ *
+ * \details The filled prefix of `dest` is doubled until it reaches this size. After that it's
+ * copied by chunks of this size, so the source of the copying stays in the cache.
+ */
+#define __M3C_MEMFILL_MAX_CHUNK (64 * 1024)
+
+void *m3c_memfill(
+    void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t len, m3c_size_t count
+) {
+    char *_dest = dest;
+    m3c_size_t size = len * count;
+    m3c_size_t filled;
+    m3c_size_t chunk;
+
+    if (size == 0)
+        return dest;
+
+#ifndef M3C_FEATURE_USE_COMPILER_BUILTIN_FUNCTIONS
+    /* NOTE: short patterns that divide 8 are filled with set kernels */
+    if (len == 1 || len == 2 || len == 4 || len == 8) {
+        const unsigned char *_src = src;
+        unsigned long long pattern = 0;
+        int i;
+
+        for (i = 0; i < 8; ++i)
+            pattern |= (unsigned long long)_src[i % len] << (8 * i);
+
+        return __m3c_memset_pattern(dest, pattern, size);
+    }
+#else
+    if (len == 1)
+        return m3c_memset(dest, *(const unsigned char *)src, count);
+#endif /* M3C_FEATURE_USE_COMPILER_BUILTIN_FUNCTIONS */
+
+    /* NOTE: copy the pattern once, then copy the already filled prefix after itself */
+    m3c_memcpy(_dest, src, len);
+
+    for (filled = len, chunk = len; filled < size;) {
+        if (chunk > size - filled)
+            chunk = size - filled;
 
-    while (count > 0) {
-        *_dest = (unsigned char)ch;
+        m3c_memcpy(_dest + filled, _dest, chunk);
+        filled += chunk;
 
-        --count;
-        ++_dest;
+        /* NOTE: `filled` is a multiple of `len` (unless it's the last iteration) */
+        if (filled <= __M3C_MEMFILL_MAX_CHUNK)
+            chunk = filled;
     }
 
     return dest;
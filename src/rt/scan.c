@@ -0,0 +1,101 @@
+#include <m3c/rt/scan.h>
+
+#include <m3c/rt/x86-64/scan.h>
+
+/**
+ * \brief Byte-at-a-time version of #M3C_Scan_SkipText.
+ */
+m3c_u8 const *__M3C_Scan_SkipText_Byte(m3c_u8 const *ptr, m3c_u8 const *last) {
+    while (ptr <= last && *ptr < 0x80 && *ptr != '\n' && *ptr != '\r')
+        ++ptr;
+
+    return ptr;
+}
+
+/**
+ * \brief Byte-at-a-time version of #M3C_Scan_SkipBlanks.
+ */
+m3c_u8 const *__M3C_Scan_SkipBlanks_Byte(m3c_u8 const *ptr, m3c_u8 const *last) {
+    while (ptr <= last && (*ptr == ' ' || *ptr == '\t'))
+        ++ptr;
+
+    return ptr;
+}
+
+/**
+ * \brief Byte-at-a-time version of #M3C_Scan_FindEOLs.
+ */
+m3c_size_t __M3C_Scan_FindEOLs_Byte(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+) {
+    m3c_size_t n = 0;
+
+    for (; ptr <= last && n < maxN; ++ptr) {
+        if (*ptr == '\n' || *ptr == '\r')
+            eols[n++] = ptr;
+    }
+
+    return n;
+}
+
+/**
+ * \brief Byte-at-a-time version of #M3C_Scan_CountEOLs.
+ */
+m3c_size_t __M3C_Scan_CountEOLs_Byte(m3c_u8 const *ptr, m3c_u8 const *last) {
+    m3c_size_t n = 0;
+
+    for (; ptr <= last; ++ptr) {
+        if (*ptr == '\n' || (*ptr == '\r' && (ptr == last || ptr[1] != '\n')))
+            ++n;
+    }
+
+    return n;
+}
+
+typedef m3c_u8 const *(*__M3C_ScanFn)(m3c_u8 const *ptr, m3c_u8 const *last);
+typedef m3c_size_t (*__M3C_ScanFindFn)(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **found, m3c_size_t maxN
+);
+typedef m3c_size_t (*__M3C_ScanCountFn)(m3c_u8 const *ptr, m3c_u8 const *last);
+
+#ifdef M3C_X86_64_SIMD
+/* NOTE: SSE2 is a part of x86-64, so it's safe to use it without detection */
+static __M3C_ScanFn __m3c_scan_skip_text = __M3C_Scan_SkipText_SSE2;
+static __M3C_ScanFn __m3c_scan_skip_blanks = __M3C_Scan_SkipBlanks_SSE2;
+static __M3C_ScanFindFn __m3c_scan_find_eols = __M3C_Scan_FindEOLs_SSE2;
+static __M3C_ScanCountFn __m3c_scan_count_eols = __M3C_Scan_CountEOLs_SSE2;
+#else
+static __M3C_ScanFn __m3c_scan_skip_text = __M3C_Scan_SkipText_Byte;
+static __M3C_ScanFn __m3c_scan_skip_blanks = __M3C_Scan_SkipBlanks_Byte;
+static __M3C_ScanFindFn __m3c_scan_find_eols = __M3C_Scan_FindEOLs_Byte;
+static __M3C_ScanCountFn __m3c_scan_count_eols = __M3C_Scan_CountEOLs_Byte;
+#endif
+
+void M3C_Scan_Init(void) {
+#ifdef M3C_X86_64_SIMD
+    if (M3C_CPU_DetectFeatures() & M3C_CPU_FEATURE_AVX2) {
+        __m3c_scan_skip_text = __M3C_Scan_SkipText_AVX2;
+        __m3c_scan_skip_blanks = __M3C_Scan_SkipBlanks_AVX2;
+        __m3c_scan_find_eols = __M3C_Scan_FindEOLs_AVX2;
+        __m3c_scan_count_eols = __M3C_Scan_CountEOLs_AVX2;
+    }
+#endif
+}
+
+m3c_u8 const *M3C_Scan_SkipText(m3c_u8 const *ptr, m3c_u8 const *last) {
+    return __m3c_scan_skip_text(ptr, last);
+}
+
+m3c_u8 const *M3C_Scan_SkipBlanks(m3c_u8 const *ptr, m3c_u8 const *last) {
+    return __m3c_scan_skip_blanks(ptr, last);
+}
+
+m3c_size_t M3C_Scan_FindEOLs(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+) {
+    return __m3c_scan_find_eols(ptr, last, eols, maxN);
+}
+
+m3c_size_t M3C_Scan_CountEOLs(m3c_u8 const *ptr, m3c_u8 const *last) {
+    return __m3c_scan_count_eols(ptr, last);
+}
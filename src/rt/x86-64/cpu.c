@@ -0,0 +1,59 @@
+#include <m3c/rt/x86-64/cpu.h>
+
+#include <m3c/common/types.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/**
+ * \brief Executes `cpuid` instruction.
+ *
+ * \param      leaf    value of `eax`
+ * \param      subleaf value of `ecx`
+ * \param[out] regs    values of `eax`, `ebx`, `ecx` and `edx` (in that order)
+ */
+void __M3C_CPU_CPUID(m3c_u32 leaf, m3c_u32 subleaf, m3c_u32 regs[4]) {
+    __asm__ __volatile__("cpuid"
+                         : "=a"(regs[0]), "=b"(regs[1]), "=c"(regs[2]), "=d"(regs[3])
+                         : "a"(leaf), "c"(subleaf));
+}
+
+/**
+ * \brief Reads extended control register `XCR0` with `xgetbv` instruction.
+ *
+ * \warning Must be called only if `OSXSAVE` is set.
+ */
+m3c_u32 __M3C_CPU_ReadXCR0(void) {
+    m3c_u32 eax, edx;
+
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return eax;
+}
+
+unsigned M3C_CPU_DetectFeatures(void) {
+    m3c_u32 regs[4];
+    m3c_u32 maxLeaf;
+    unsigned features = M3C_CPU_FEATURE_SSE2;
+
+    __M3C_CPU_CPUID(0, 0, regs);
+    maxLeaf = regs[0];
+    if (maxLeaf < 7)
+        return features;
+
+    /* NOTE: AVX needs both CPU support (bit 28) and OS support via `xsave` (bit 27) */
+    __M3C_CPU_CPUID(1, 0, regs);
+    if ((regs[2] & (1UL << 27)) == 0 || (regs[2] & (1UL << 28)) == 0)
+        return features;
+
+    /* NOTE: the OS must save both XMM (bit 1) and YMM (bit 2) registers */
+    if ((__M3C_CPU_ReadXCR0() & 0x6) != 0x6)
+        return features;
+
+    __M3C_CPU_CPUID(7, 0, regs);
+    if (regs[1] & (1UL << 5))
+        features |= M3C_CPU_FEATURE_AVX2;
+
+    return features;
+}
+
+#endif /* M3C_X86_64_SIMD */
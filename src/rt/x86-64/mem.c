@@ -0,0 +1,224 @@
+#include <m3c/rt/x86-64/mem.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/* NOTE: vectors used for memory access. They are unaligned and may alias any object */
+typedef char __M3C_V16 __attribute__((vector_size(16), aligned(1), may_alias));
+typedef char __M3C_V32 __attribute__((vector_size(32), aligned(1), may_alias));
+
+/**
+ * \brief Copies less than 16 bytes.
+ *
+ * \details Copies with two (possibly overlapping) loads and stores of the largest fitting size.
+ */
+static void __M3C_Memcpy_Small(char *dest, const char *src, m3c_size_t count) {
+    typedef m3c_u32 __attribute__((aligned(1), may_alias)) u32;
+    typedef m3c_u16 __attribute__((aligned(1), may_alias)) u16;
+    typedef unsigned long long __attribute__((aligned(1), may_alias)) u64;
+
+    if (count >= 8) {
+        u64 head = *(const u64 *)src;
+        u64 tail = *(const u64 *)(src + count - 8);
+        *(u64 *)dest = head;
+        *(u64 *)(dest + count - 8) = tail;
+    } else if (count >= 4) {
+        u32 head = *(const u32 *)src;
+        u32 tail = *(const u32 *)(src + count - 4);
+        *(u32 *)dest = head;
+        *(u32 *)(dest + count - 4) = tail;
+    } else if (count >= 2) {
+        u16 head = *(const u16 *)src;
+        u16 tail = *(const u16 *)(src + count - 2);
+        *(u16 *)dest = head;
+        *(u16 *)(dest + count - 2) = tail;
+    } else if (count == 1)
+        *dest = *src;
+}
+
+void *__M3C_Memcpy_SSE2(void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t count) {
+    char *d = dest;
+    const char *s = src;
+    __M3C_V16 head, tail;
+    m3c_size_t skip;
+
+    if (count < 16) {
+        __M3C_Memcpy_Small(d, s, count);
+        return dest;
+    }
+
+    /* NOTE: head and tail are copied unaligned, the rest is copied with aligned stores */
+    head = *(const __M3C_V16 *)s;
+    tail = *(const __M3C_V16 *)(s + count - 16);
+
+    skip = 16 - ((m3c_size_t)d & 15);
+    *(__M3C_V16 *)d = head;
+    d += skip;
+    s += skip;
+    count -= skip;
+
+    for (; count > 64; count -= 64, d += 64, s += 64) {
+        __M3C_V16 a = *(const __M3C_V16 *)s;
+        __M3C_V16 b = *(const __M3C_V16 *)(s + 16);
+        __M3C_V16 c = *(const __M3C_V16 *)(s + 32);
+        __M3C_V16 e = *(const __M3C_V16 *)(s + 48);
+        *(__M3C_V16 *)d = a;
+        *(__M3C_V16 *)(d + 16) = b;
+        *(__M3C_V16 *)(d + 32) = c;
+        *(__M3C_V16 *)(d + 48) = e;
+    }
+    for (; count > 16; count -= 16, d += 16, s += 16)
+        *(__M3C_V16 *)d = *(const __M3C_V16 *)s;
+
+    *(__M3C_V16 *)(d + count - 16) = tail;
+
+    return dest;
+}
+
+M3C_TARGET("avx2")
+void *__M3C_Memcpy_AVX2(void *m3c_restrict dest, const void *m3c_restrict src, m3c_size_t count) {
+    char *d = dest;
+    const char *s = src;
+    __M3C_V32 head, tail;
+    m3c_size_t skip;
+
+    if (count < 32) {
+        if (count < 16) {
+            __M3C_Memcpy_Small(d, s, count);
+        } else {
+            __M3C_V16 h = *(const __M3C_V16 *)s;
+            __M3C_V16 t = *(const __M3C_V16 *)(s + count - 16);
+            *(__M3C_V16 *)d = h;
+            *(__M3C_V16 *)(d + count - 16) = t;
+        }
+        return dest;
+    }
+
+    head = *(const __M3C_V32 *)s;
+    tail = *(const __M3C_V32 *)(s + count - 32);
+
+    skip = 32 - ((m3c_size_t)d & 31);
+    *(__M3C_V32 *)d = head;
+    d += skip;
+    s += skip;
+    count -= skip;
+
+    for (; count > 128; count -= 128, d += 128, s += 128) {
+        __M3C_V32 a = *(const __M3C_V32 *)s;
+        __M3C_V32 b = *(const __M3C_V32 *)(s + 32);
+        __M3C_V32 c = *(const __M3C_V32 *)(s + 64);
+        __M3C_V32 e = *(const __M3C_V32 *)(s + 96);
+        *(__M3C_V32 *)d = a;
+        *(__M3C_V32 *)(d + 32) = b;
+        *(__M3C_V32 *)(d + 64) = c;
+        *(__M3C_V32 *)(d + 96) = e;
+    }
+    for (; count > 32; count -= 32, d += 32, s += 32)
+        *(__M3C_V32 *)d = *(const __M3C_V32 *)s;
+
+    *(__M3C_V32 *)(d + count - 32) = tail;
+
+    return dest;
+}
+
+/**
+ * \brief Rotates the 8-byte pattern so that it starts from its byte `phase`.
+ */
+#    define __M3C_PATTERN_ROTATE(pattern, phase)                                                   \
+        ((phase) % 8 == 0                                                                          \
+             ? (pattern)                                                                           \
+             : (pattern) >> (8 * ((phase) % 8)) | (pattern) << (64 - 8 * ((phase) % 8)))
+
+/**
+ * \brief Fills less than 16 bytes with the 8-byte pattern.
+ */
+static void __M3C_MemsetPattern_Small(char *dest, unsigned long long pattern, m3c_size_t count) {
+    typedef m3c_u32 __attribute__((aligned(1), may_alias)) u32;
+    typedef m3c_u16 __attribute__((aligned(1), may_alias)) u16;
+    typedef unsigned long long __attribute__((aligned(1), may_alias)) u64;
+
+    /* NOTE: the store at offset `o` has to start from the byte `o % 8` of the pattern */
+    if (count >= 8) {
+        *(u64 *)dest = pattern;
+        *(u64 *)(dest + count - 8) = __M3C_PATTERN_ROTATE(pattern, count - 8);
+    } else if (count >= 4) {
+        *(u32 *)dest = (m3c_u32)pattern;
+        *(u32 *)(dest + count - 4) = (m3c_u32)__M3C_PATTERN_ROTATE(pattern, count - 4);
+    } else if (count >= 2) {
+        *(u16 *)dest = (m3c_u16)pattern;
+        *(u16 *)(dest + count - 2) = (m3c_u16)__M3C_PATTERN_ROTATE(pattern, count - 2);
+    } else if (count == 1)
+        *dest = (char)pattern;
+}
+
+void *__M3C_MemsetPattern_SSE2(void *dest, unsigned long long pattern, m3c_size_t count) {
+    typedef unsigned long long __M3C_V2U64 __attribute__((vector_size(16)));
+    char *d = dest;
+    char *end = d + count;
+    m3c_size_t skip;
+    unsigned long long rotated;
+
+    if (count < 16) {
+        __M3C_MemsetPattern_Small(d, pattern, count);
+        return dest;
+    }
+
+    *(__M3C_V16 *)d = (__M3C_V16)(__M3C_V2U64){pattern, pattern};
+    skip = 16 - ((m3c_size_t)d & 15);
+    d += skip;
+
+    rotated = __M3C_PATTERN_ROTATE(pattern, skip);
+    {
+        __M3C_V16 v = (__M3C_V16)(__M3C_V2U64){rotated, rotated};
+
+        for (; end - d > 64; d += 64) {
+            *(__M3C_V16 *)d = v;
+            *(__M3C_V16 *)(d + 16) = v;
+            *(__M3C_V16 *)(d + 32) = v;
+            *(__M3C_V16 *)(d + 48) = v;
+        }
+        for (; end - d > 16; d += 16)
+            *(__M3C_V16 *)d = v;
+    }
+
+    rotated = __M3C_PATTERN_ROTATE(pattern, count - 16);
+    *(__M3C_V16 *)(end - 16) = (__M3C_V16)(__M3C_V2U64){rotated, rotated};
+
+    return dest;
+}
+
+M3C_TARGET("avx2")
+void *__M3C_MemsetPattern_AVX2(void *dest, unsigned long long pattern, m3c_size_t count) {
+    typedef unsigned long long __M3C_V4U64 __attribute__((vector_size(32)));
+    char *d = dest;
+    char *end = d + count;
+    m3c_size_t skip;
+    unsigned long long rotated;
+
+    if (count < 32)
+        return __M3C_MemsetPattern_SSE2(dest, pattern, count);
+
+    *(__M3C_V32 *)d = (__M3C_V32)(__M3C_V4U64){pattern, pattern, pattern, pattern};
+    skip = 32 - ((m3c_size_t)d & 31);
+    d += skip;
+
+    rotated = __M3C_PATTERN_ROTATE(pattern, skip);
+    {
+        __M3C_V32 v = (__M3C_V32)(__M3C_V4U64){rotated, rotated, rotated, rotated};
+
+        for (; end - d > 128; d += 128) {
+            *(__M3C_V32 *)d = v;
+            *(__M3C_V32 *)(d + 32) = v;
+            *(__M3C_V32 *)(d + 64) = v;
+            *(__M3C_V32 *)(d + 96) = v;
+        }
+        for (; end - d > 32; d += 32)
+            *(__M3C_V32 *)d = v;
+    }
+
+    rotated = __M3C_PATTERN_ROTATE(pattern, count - 32);
+    *(__M3C_V32 *)(end - 32) = (__M3C_V32)(__M3C_V4U64){rotated, rotated, rotated, rotated};
+
+    return dest;
+}
+
+#endif /* M3C_X86_64_SIMD */
@@ -0,0 +1,234 @@
+#include <m3c/rt/x86-64/scan.h>
+#include <m3c/rt/x86-64/simd.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/**
+ * \brief Body of the scanning kernel. Returns the pointer to the first byte of `[ptr, last]` for
+ * which `STOP(v)` is set or `last + 1`.
+ *
+ * \details Whole vectors are loaded while they fit. If the range is at least `WIDTH` bytes long,
+ * its tail is loaded as one vector overlapping already checked bytes. Shorter ranges are passed to
+ * `FALLBACK`.
+ *
+ * \warning Requires `ptr` and `last` parameters.
+ */
+#    define __M3C_SCAN_BODY(VEC, VEC_U, WIDTH, MOVEMASK, STOP, FALLBACK)                           \
+        m3c_u8 const *first = ptr;                                                                 \
+        VEC v;                                                                                     \
+        unsigned mask;                                                                             \
+        m3c_size_t left;                                                                           \
+                                                                                                   \
+        for (; last - ptr >= (WIDTH) - 1; ptr += (WIDTH)) {                                        \
+            v = *(const VEC_U *)ptr;                                                               \
+            mask = MOVEMASK(STOP(v));                                                              \
+            if (mask)                                                                              \
+                return ptr + __builtin_ctz(mask);                                                  \
+        }                                                                                          \
+                                                                                                   \
+        left = (m3c_size_t)(last + 1 - ptr);                                                       \
+        if (left == 0)                                                                             \
+            return ptr;                                                                            \
+                                                                                                   \
+        /* NOTE: checking that `ptr - first + left >= WIDTH` */                                    \
+        if ((m3c_size_t)(ptr - first) >= (WIDTH) - left) {                                         \
+            v = *(const VEC_U *)(last + 1 - (WIDTH));                                              \
+            mask = MOVEMASK(STOP(v)) >> ((WIDTH) - left);                                          \
+                                                                                                   \
+            return mask ? ptr + __builtin_ctz(mask) : last + 1;                                    \
+        }                                                                                          \
+                                                                                                   \
+        return FALLBACK(ptr, last)
+
+/**
+ * \brief Body of the finding kernel. Writes to `eols` pointers to bytes of `[ptr, last]` for which
+ * `STOP(v)` is set (at most `maxN`) and returns their number.
+ *
+ * \details Vectors are loaded as in #__M3C_SCAN_BODY.
+ *
+ * \warning Requires `ptr`, `last`, `eols` and `maxN` parameters.
+ */
+#    define __M3C_FIND_BODY(VEC, VEC_U, WIDTH, MOVEMASK, STOP, FALLBACK)                           \
+        m3c_u8 const *first = ptr;                                                                 \
+        m3c_size_t n = 0;                                                                          \
+        VEC v;                                                                                     \
+        unsigned mask;                                                                             \
+        m3c_size_t left;                                                                           \
+                                                                                                   \
+        for (; last - ptr >= (WIDTH) - 1; ptr += (WIDTH)) {                                        \
+            v = *(const VEC_U *)ptr;                                                               \
+            for (mask = MOVEMASK(STOP(v)); mask; mask &= mask - 1) {                               \
+                if (n == maxN)                                                                     \
+                    return n;                                                                      \
+                eols[n++] = ptr + __builtin_ctz(mask);                                             \
+            }                                                                                      \
+        }                                                                                          \
+                                                                                                   \
+        left = (m3c_size_t)(last + 1 - ptr);                                                       \
+        if (left == 0)                                                                             \
+            return n;                                                                              \
+                                                                                                   \
+        /* NOTE: checking that `ptr - first + left >= WIDTH` */                                    \
+        if ((m3c_size_t)(ptr - first) >= (WIDTH) - left) {                                         \
+            v = *(const VEC_U *)(last + 1 - (WIDTH));                                              \
+            for (mask = MOVEMASK(STOP(v)) >> ((WIDTH) - left); mask; mask &= mask - 1) {           \
+                if (n == maxN)                                                                     \
+                    return n;                                                                      \
+                eols[n++] = ptr + __builtin_ctz(mask);                                             \
+            }                                                                                      \
+                                                                                                   \
+            return n;                                                                              \
+        }                                                                                          \
+                                                                                                   \
+        return n + FALLBACK(ptr, last, eols + n, maxN - n)
+
+/**
+ * \brief Body of the counting kernel. Returns the number of EOLs in `[ptr, last]`.
+ *
+ * \details `\r` followed by `\n` isn't counted, so `\r\n` is one EOL. Thus each vector is compared
+ * with the one loaded a byte further and whole vectors are loaded while that byte is in the range.
+ * The rest (at most `WIDTH` bytes) is passed to `FALLBACK`.
+ *
+ * \warning Requires `ptr` and `last` parameters.
+ */
+#    define __M3C_COUNT_BODY(VEC, VEC_U, WIDTH, MOVEMASK, FALLBACK)                                \
+        m3c_size_t n = 0;                                                                          \
+        VEC v;                                                                                     \
+        VEC next;                                                                                  \
+        unsigned mask;                                                                             \
+                                                                                                   \
+        for (; last - ptr >= (WIDTH); ptr += (WIDTH)) {                                            \
+            v = *(const VEC_U *)ptr;                                                               \
+            next = *(const VEC_U *)(ptr + 1);                                                      \
+            for (mask = MOVEMASK(__M3C_STOP_LAST_EOL(v, next)); mask; mask &= mask - 1)            \
+                ++n;                                                                               \
+        }                                                                                          \
+                                                                                                   \
+        return n + FALLBACK(ptr, last)
+
+/**
+ * \brief Sets bytes that end an EOL (`\n` and `\r` that isn't followed by `\n`).
+ */
+#    define __M3C_STOP_LAST_EOL(v, next) (((v) == '\n') | (((v) == '\r') & ((next) != '\n')))
+
+/**
+ * \brief Sets bytes that are EOL.
+ */
+#    define __M3C_STOP_EOL(v) (((v) == '\n') | ((v) == '\r'))
+
+/**
+ * \brief Sets bytes that are EOL or non-ASCII.
+ */
+#    define __M3C_STOP_TEXT(v) (((v) == '\n') | ((v) == '\r') | ((v) < 0))
+
+/**
+ * \brief Sets bytes that are neither space nor `\t`.
+ */
+#    define __M3C_STOP_BLANKS(v) (((v) != ' ') & ((v) != '\t'))
+
+/**
+ * \brief Byte-at-a-time version of #__M3C_Scan_SkipText_SSE2 (for ranges shorter than a vector).
+ */
+static m3c_u8 const *__M3C_Scan_SkipText_Small(m3c_u8 const *ptr, m3c_u8 const *last) {
+    while (ptr <= last && *ptr < 0x80 && *ptr != '\n' && *ptr != '\r')
+        ++ptr;
+
+    return ptr;
+}
+
+/**
+ * \brief Byte-at-a-time version of #__M3C_Scan_SkipBlanks_SSE2 (for ranges shorter than a vector).
+ */
+static m3c_u8 const *__M3C_Scan_SkipBlanks_Small(m3c_u8 const *ptr, m3c_u8 const *last) {
+    while (ptr <= last && (*ptr == ' ' || *ptr == '\t'))
+        ++ptr;
+
+    return ptr;
+}
+
+/**
+ * \brief Byte-at-a-time version of #__M3C_Scan_FindEOLs_SSE2 (for ranges shorter than a vector).
+ */
+static m3c_size_t __M3C_Scan_FindEOLs_Small(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+) {
+    m3c_size_t n = 0;
+
+    for (; ptr <= last && n < maxN; ++ptr) {
+        if (*ptr == '\n' || *ptr == '\r')
+            eols[n++] = ptr;
+    }
+
+    return n;
+}
+
+/**
+ * \brief Byte-at-a-time version of #__M3C_Scan_CountEOLs_SSE2 (for ranges shorter than a vector).
+ */
+static m3c_size_t __M3C_Scan_CountEOLs_Small(m3c_u8 const *ptr, m3c_u8 const *last) {
+    m3c_size_t n = 0;
+
+    for (; ptr <= last; ++ptr) {
+        if (*ptr == '\n' || (*ptr == '\r' && (ptr == last || ptr[1] != '\n')))
+            ++n;
+    }
+
+    return n;
+}
+
+m3c_u8 const *__M3C_Scan_SkipText_SSE2(m3c_u8 const *ptr, m3c_u8 const *last) {
+    __M3C_SCAN_BODY(
+        __M3C_I8x16, __M3C_I8x16U, 16, __M3C_MOVEMASK_16, __M3C_STOP_TEXT,
+        __M3C_Scan_SkipText_Small
+    );
+}
+
+M3C_TARGET("avx2")
+m3c_u8 const *__M3C_Scan_SkipText_AVX2(m3c_u8 const *ptr, m3c_u8 const *last) {
+    __M3C_SCAN_BODY(
+        __M3C_I8x32, __M3C_I8x32U, 32, __M3C_MOVEMASK_32, __M3C_STOP_TEXT, __M3C_Scan_SkipText_SSE2
+    );
+}
+
+m3c_u8 const *__M3C_Scan_SkipBlanks_SSE2(m3c_u8 const *ptr, m3c_u8 const *last) {
+    __M3C_SCAN_BODY(
+        __M3C_I8x16, __M3C_I8x16U, 16, __M3C_MOVEMASK_16, __M3C_STOP_BLANKS,
+        __M3C_Scan_SkipBlanks_Small
+    );
+}
+
+M3C_TARGET("avx2")
+m3c_u8 const *__M3C_Scan_SkipBlanks_AVX2(m3c_u8 const *ptr, m3c_u8 const *last) {
+    __M3C_SCAN_BODY(
+        __M3C_I8x32, __M3C_I8x32U, 32, __M3C_MOVEMASK_32, __M3C_STOP_BLANKS,
+        __M3C_Scan_SkipBlanks_SSE2
+    );
+}
+
+m3c_size_t __M3C_Scan_FindEOLs_SSE2(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+) {
+    __M3C_FIND_BODY(
+        __M3C_I8x16, __M3C_I8x16U, 16, __M3C_MOVEMASK_16, __M3C_STOP_EOL, __M3C_Scan_FindEOLs_Small
+    );
+}
+
+M3C_TARGET("avx2")
+m3c_size_t __M3C_Scan_FindEOLs_AVX2(
+    m3c_u8 const *ptr, m3c_u8 const *last, m3c_u8 const **eols, m3c_size_t maxN
+) {
+    __M3C_FIND_BODY(
+        __M3C_I8x32, __M3C_I8x32U, 32, __M3C_MOVEMASK_32, __M3C_STOP_EOL, __M3C_Scan_FindEOLs_SSE2
+    );
+}
+
+m3c_size_t __M3C_Scan_CountEOLs_SSE2(m3c_u8 const *ptr, m3c_u8 const *last) {
+    __M3C_COUNT_BODY(__M3C_I8x16, __M3C_I8x16U, 16, __M3C_MOVEMASK_16, __M3C_Scan_CountEOLs_Small);
+}
+
+M3C_TARGET("avx2")
+m3c_size_t __M3C_Scan_CountEOLs_AVX2(m3c_u8 const *ptr, m3c_u8 const *last) {
+    __M3C_COUNT_BODY(__M3C_I8x32, __M3C_I8x32U, 32, __M3C_MOVEMASK_32, __M3C_Scan_CountEOLs_SSE2);
+}
+
+#endif /* M3C_X86_64_SIMD */
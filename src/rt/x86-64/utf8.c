@@ -0,0 +1,218 @@
+#include <m3c/rt/x86-64/utf8.h>
+#include <m3c/rt/x86-64/simd.h>
+
+#include <m3c/common/utf8.h>
+#include <m3c/common/macros.h>
+
+#ifdef M3C_X86_64_SIMD
+
+/* NOTE: error bits of the lookup tables. Each table sets the bits of the errors that are possible
+ * for its nibble, so an error is found iff its bit is set in all three tables */
+
+/* NOTE: a lead byte isn't followed by a continuation byte */
+#    define __M3C_UTF8_TOO_SHORT (1 << 0)
+/* NOTE: an ASCII byte is followed by a continuation byte */
+#    define __M3C_UTF8_TOO_LONG (1 << 1)
+/* NOTE: `E0 80..9F` */
+#    define __M3C_UTF8_OVERLONG_3 (1 << 2)
+/* NOTE: `F4 90..BF` and `F5..FF __` */
+#    define __M3C_UTF8_TOO_LARGE (1 << 3)
+/* NOTE: `ED A0..BF` */
+#    define __M3C_UTF8_SURROGATE (1 << 4)
+/* NOTE: `C0..C1 __` */
+#    define __M3C_UTF8_OVERLONG_2 (1 << 5)
+/* NOTE: `F5..FF 80..8F` (the rest is caught by #__M3C_UTF8_TOO_LARGE) */
+#    define __M3C_UTF8_TOO_LARGE_1000 (1 << 6)
+/* NOTE: `F0 80..8F` */
+#    define __M3C_UTF8_OVERLONG_4 (1 << 6)
+/* NOTE: two continuation bytes in a row. It's an error iff the second one isn't expected as the
+ * third or the fourth byte of a code point */
+#    define __M3C_UTF8_TWO_CONTS (1 << 7)
+
+#    define __M3C_UTF8_CARRY (__M3C_UTF8_TOO_SHORT | __M3C_UTF8_TOO_LONG | __M3C_UTF8_TWO_CONTS)
+
+/**
+ * \brief Table for the high nibble of the previous byte.
+ */
+#    define __M3C_UTF8_BYTE_1_HIGH                                                                 \
+        __M3C_UTF8_TOO_LONG, __M3C_UTF8_TOO_LONG, __M3C_UTF8_TOO_LONG, __M3C_UTF8_TOO_LONG,        \
+            __M3C_UTF8_TOO_LONG, __M3C_UTF8_TOO_LONG, __M3C_UTF8_TOO_LONG, __M3C_UTF8_TOO_LONG,    \
+            __M3C_UTF8_TWO_CONTS, __M3C_UTF8_TWO_CONTS, __M3C_UTF8_TWO_CONTS,                      \
+            __M3C_UTF8_TWO_CONTS, __M3C_UTF8_TOO_SHORT | __M3C_UTF8_OVERLONG_2,                    \
+            __M3C_UTF8_TOO_SHORT,                                                                  \
+            __M3C_UTF8_TOO_SHORT | __M3C_UTF8_OVERLONG_3 | __M3C_UTF8_SURROGATE,                   \
+            __M3C_UTF8_TOO_SHORT | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000 |              \
+                __M3C_UTF8_OVERLONG_4
+
+/**
+ * \brief Table for the low nibble of the previous byte.
+ */
+#    define __M3C_UTF8_BYTE_1_LOW                                                                  \
+        __M3C_UTF8_CARRY | __M3C_UTF8_OVERLONG_3 | __M3C_UTF8_OVERLONG_2 | __M3C_UTF8_OVERLONG_4,  \
+            __M3C_UTF8_CARRY | __M3C_UTF8_OVERLONG_2, __M3C_UTF8_CARRY, __M3C_UTF8_CARRY,          \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE,                                               \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000 |                  \
+                __M3C_UTF8_SURROGATE,                                                              \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000,                   \
+            __M3C_UTF8_CARRY | __M3C_UTF8_TOO_LARGE | __M3C_UTF8_TOO_LARGE_1000
+
+/**
+ * \brief Table for the high nibble of the current byte.
+ */
+#    define __M3C_UTF8_BYTE_2_HIGH                                                                 \
+        __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT,    \
+            __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT,                      \
+            __M3C_UTF8_TOO_SHORT,                                                                  \
+            __M3C_UTF8_TOO_LONG | __M3C_UTF8_OVERLONG_2 | __M3C_UTF8_TWO_CONTS |                   \
+                __M3C_UTF8_OVERLONG_3 | __M3C_UTF8_TOO_LARGE_1000 | __M3C_UTF8_OVERLONG_4,         \
+            __M3C_UTF8_TOO_LONG | __M3C_UTF8_OVERLONG_2 | __M3C_UTF8_TWO_CONTS |                   \
+                __M3C_UTF8_OVERLONG_3 | __M3C_UTF8_TOO_LARGE,                                      \
+            __M3C_UTF8_TOO_LONG | __M3C_UTF8_OVERLONG_2 | __M3C_UTF8_TWO_CONTS |                   \
+                __M3C_UTF8_SURROGATE | __M3C_UTF8_TOO_LARGE,                                       \
+            __M3C_UTF8_TOO_LONG | __M3C_UTF8_OVERLONG_2 | __M3C_UTF8_TWO_CONTS |                   \
+                __M3C_UTF8_SURROGATE | __M3C_UTF8_TOO_LARGE,                                       \
+            __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT, __M3C_UTF8_TOO_SHORT
+
+/**
+ * \brief Looks up `table` (16 bytes repeated in both lanes) by indexes `idx` (`0..15`).
+ */
+#    define __M3C_LOOKUP_32(table, idx)                                                            \
+        ((__M3C_U8x32)__builtin_ia32_pshufb256((__M3C_C8x32)(table), (__M3C_C8x32)(idx)))
+
+/**
+ * \brief Validates code points of `[*ptr, last]` one by one until `*ptr` reaches `end`.
+ *
+ * \details Moves `*ptr` to the first byte of the code point after the last validated one.
+ *
+ * \return #M3C_UTF8_OK or #M3C_UTF8_ERR
+ */
+static int __M3C_UTF8ValidateUntil(
+    m3c_u8 const **ptr, m3c_u8 const *last, m3c_u8 const *end, m3c_bool *isASCII
+) {
+    while (*ptr < end && *ptr <= last) {
+        if (**ptr >= 0x80)
+            *isASCII = m3c_false;
+
+        if (M3C_UTF8ValidateCodepoint(ptr, last) != M3C_UTF8_OK)
+            return M3C_UTF8_ERR;
+    }
+
+    return M3C_UTF8_OK;
+}
+
+int __M3C_UTF8ValidateBuffer_SSE2(m3c_u8 const *ptr, m3c_u8 const *last, m3c_bool *isASCII) {
+    m3c_bool ascii = m3c_true;
+
+    if (last < ptr) {
+        *isASCII = m3c_true;
+        return M3C_UTF8_OK;
+    }
+
+    M3C_LOOP {
+        /* NOTE: skipping ASCII vectors */
+        for (; last - ptr >= 15; ptr += 16) {
+            if (__M3C_MOVEMASK_16(*(const __M3C_I8x16U *)ptr))
+                break;
+        }
+        if (last - ptr < 15)
+            break;
+
+        /* NOTE: the code point at the end of the vector can go beyond it, so `ptr` is always at the
+         * start of a code point */
+        if (__M3C_UTF8ValidateUntil(&ptr, last, ptr + 16, &ascii) != M3C_UTF8_OK)
+            return M3C_UTF8_ERR;
+    }
+
+    if (__M3C_UTF8ValidateUntil(&ptr, last, last + 1, &ascii) != M3C_UTF8_OK)
+        return M3C_UTF8_ERR;
+
+    *isASCII = ascii;
+    return M3C_UTF8_OK;
+}
+
+M3C_TARGET("avx2")
+int __M3C_UTF8ValidateBuffer_AVX2(m3c_u8 const *ptr, m3c_u8 const *last, m3c_bool *isASCII) {
+    __M3C_U8x32 const byte1High = {__M3C_UTF8_BYTE_1_HIGH, __M3C_UTF8_BYTE_1_HIGH};
+    __M3C_U8x32 const byte1Low = {__M3C_UTF8_BYTE_1_LOW, __M3C_UTF8_BYTE_1_LOW};
+    __M3C_U8x32 const byte2High = {__M3C_UTF8_BYTE_2_HIGH, __M3C_UTF8_BYTE_2_HIGH};
+
+    m3c_u8 const *tail;
+    m3c_bool ascii = m3c_true;
+    int n;
+
+    __M3C_U8x32 v;
+    __M3C_U8x32 prev1;
+    __M3C_U8x32 prev2;
+    __M3C_U8x32 prev3;
+    __M3C_U8x32 special;
+    __M3C_U8x32 must23;
+    __M3C_U8x32 errors = {0};
+    __M3C_U8x32 high = {0};
+
+    if (last < ptr) {
+        *isASCII = m3c_true;
+        return M3C_UTF8_OK;
+    }
+
+    /* NOTE: the previous 3 bytes of each vector are loaded from memory, so the first code points
+     * are validated one by one */
+    if (__M3C_UTF8ValidateUntil(&ptr, last, last - ptr >= 2 ? ptr + 3 : last + 1, &ascii) !=
+        M3C_UTF8_OK)
+        return M3C_UTF8_ERR;
+
+    if (ptr > last) {
+        *isASCII = ascii;
+        return M3C_UTF8_OK;
+    }
+
+    for (; last - ptr >= 31; ptr += 32) {
+        v = *(const __M3C_U8x32U *)ptr;
+        prev3 = *(const __M3C_U8x32U *)(ptr - 3);
+
+        /* NOTE: there are no errors if all bytes from `ptr - 3` are ASCII */
+        if (!__M3C_MOVEMASK_32(v | prev3))
+            continue;
+
+        prev1 = *(const __M3C_U8x32U *)(ptr - 1);
+        prev2 = *(const __M3C_U8x32U *)(ptr - 2);
+        high |= v;
+
+        /* NOTE: errors of 2-byte sequences (and continuation bytes in a row) */
+        special = __M3C_LOOKUP_32(byte1High, prev1 >> 4) & __M3C_LOOKUP_32(byte1Low, prev1 & 0x0F) &
+                  __M3C_LOOKUP_32(byte2High, v >> 4);
+
+        /* NOTE: continuation bytes that must be the third or the fourth byte of a code point. They
+         * are exactly the ones with #__M3C_UTF8_TWO_CONTS set */
+        must23 = (__M3C_U8x32)((prev2 >= 0xE0) | (prev3 >= 0xF0)) & 0x80;
+
+        errors |= must23 ^ special;
+    }
+
+    if (__M3C_MOVEMASK_32(errors != 0))
+        return M3C_UTF8_ERR;
+    if (__M3C_MOVEMASK_32(high))
+        ascii = m3c_false;
+
+    /* NOTE: the last vector can cut a code point, so its lead byte (if any) is validated again with
+     * the rest of the buffer. There are at least 3 bytes before `ptr` (see above) */
+    tail = ptr;
+    for (n = 0; n < 3 && (tail[-1] & 0xC0) == 0x80; ++n)
+        --tail;
+    tail = n < 3 && tail[-1] >= 0xC0 ? tail - 1 : ptr;
+
+    if (__M3C_UTF8ValidateUntil(&tail, last, last + 1, &ascii) != M3C_UTF8_OK)
+        return M3C_UTF8_ERR;
+
+    *isASCII = ascii;
+    return M3C_UTF8_OK;
+}
+
+#endif /* M3C_X86_64_SIMD */